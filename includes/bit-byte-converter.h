@@ -10,7 +10,9 @@
 int gets();
 /// \publicsection
 #include <cstddef>
+#include <cstdint>
 #include <vector>
+#include <algorithm>
 #include <map>
 #include <utility>
 
@@ -23,44 +25,185 @@ int gets();
 /// \namespace ResearchLibrary
 namespace ResearchLibrary {
 
+/// \privatesection
+/// \fn reverse_bits(std::uint64_t value, std::size_t length)
+/// \brief reverse the lower \c length bits of \c value at once
+template <typename = int>
+std::uint64_t reverse_bits(std::uint64_t value, std::size_t length) {
+  if (length == 0) {
+    return 0;
+  }
+  constexpr std::uint64_t m1 = 0x5555555555555555;
+  constexpr std::uint64_t m2 = 0x3333333333333333;
+  constexpr std::uint64_t m4 = 0x0F0F0F0F0F0F0F0F;
+  constexpr std::uint64_t m8 = 0x00FF00FF00FF00FF;
+  constexpr std::uint64_t m16 = 0x0000FFFF0000FFFF;
+  value = (value >> 1 & m1) | (value & m1) << 1;
+  value = (value >> 2 & m2) | (value & m2) << 2;
+  value = (value >> 4 & m4) | (value & m4) << 4;
+  value = (value >> 8 & m8) | (value & m8) << 8;
+  value = (value >> 16 & m16) | (value & m16) << 16;
+  value = value >> 32 | value << 32;
+  return value >> (64 - length);
+}
+
+/// \fn count_trailing_zeros(std::uint64_t value)
+/// \brief count zeros below the lowest set bit of non-zero \c value
+template <typename = int>
+std::size_t count_trailing_zeros(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+  return std::size_t(__builtin_ctzll(value));
+#else
+  std::size_t n = 0;
+  for (; (value & 1) == 0; value >>= 1) {
+    n++;
+  }
+  return n;
+#endif
+}
+
+/// \fn count_leading_zeros(std::uint64_t value)
+/// \brief count zeros above the highest set bit of non-zero \c value
+template <typename = int>
+std::size_t count_leading_zeros(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+  return std::size_t(__builtin_clzll(value));
+#else
+  std::size_t n = 0;
+  for (; (value >> 63) == 0; value <<= 1) {
+    n++;
+  }
+  return n;
+#endif
+}
+
+/// \publicsection
+/// \enum BitOrder
+/// \brief order in which bits fill a byte;
+///        \c LSBFirst is the Deflate order, \c MSBFirst is the JPEG order
+enum class BitOrder {
+  LSBFirst,
+  MSBFirst,
+};
+
+/// \privatesection
+/// \class BitRegister
+/// \brief 64-bit register shared by the bit writers
+template <BitOrder Order>
+class BitRegister {
+ protected:
+  std::uint64_t buffered_bits;
+  std::size_t buffered_length;
+
+  BitRegister() : buffered_bits(0), buffered_length(0) {
+    return;
+  }
+
+  static std::uint64_t mask(std::size_t n) {
+    return n >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << n) - 1;
+  }
+
+  // appends bits; returns true when a whole word is ready in *word
+  bool append(std::uint64_t value, std::size_t length, std::uint64_t* word) {
+    auto v = value & mask(length);
+    auto bits_length = buffered_length + length;
+    auto filled = bits_length >= 64;
+    if (Order == BitOrder::LSBFirst) {
+      auto bits = buffered_bits | v << buffered_length;
+      if (filled) {
+        // | <-   value  -> | <- buffered -> |
+        // | <- rest -> | <-      64      -> |
+        *word = bits;
+        bits_length -= 64;
+        bits = bits_length == 0 ? 0 : v >> (length - bits_length);
+      }
+      buffered_bits = bits;
+    } else if (filled) {
+      // | <- buffered -> | <-   value  -> |
+      // | <-      64      -> | <- rest -> |
+      bits_length -= 64;
+      *word = buffered_length == 0 ? v : buffered_bits << (64 - buffered_length)
+                                         | v >> bits_length;
+      buffered_bits = v & mask(bits_length);
+    } else {
+      buffered_bits = buffered_bits << length | v;
+    }
+    buffered_length = bits_length;
+    return filled;
+  }
+
+  // empties the register; returns the bits padded with zeros to *n bytes
+  std::uint64_t drain(std::size_t* n) {
+    *n = (buffered_length + 7) / 8;
+    auto word = Order == BitOrder::LSBFirst
+              ? buffered_bits
+              : buffered_bits << (*n * 8 - buffered_length);
+    buffered_bits = 0;
+    buffered_length = 0;
+    return word;
+  }
+
+  static void store_word(uint8_t* p, std::uint64_t word, std::size_t n) {
+    for (std::size_t i = 0; i < n; i++) {
+      auto shift = Order == BitOrder::LSBFirst ? i * 8 : (n - 1 - i) * 8;
+      p[i] = static_cast<uint8_t>(word >> shift);
+    }
+    return;
+  }
+};
+
+/// \publicsection
 /// \class BitsToBytes
-/// \brief converts bit stream to byte stream
-template <std::size_t N>
-class BitsToBytes {
+/// \brief converts bit stream to byte stream;
+///        bits are collected in a 64-bit register and
+///        written out a whole word at a time.
+/// \tparam Order order of the bits in each byte
+template <std::size_t N, BitOrder Order = BitOrder::LSBFirst>
+class BitsToBytes : private BitRegister<Order> {
  private:
   std::vector<uint8_t> data;
-  std::size_t buffered_length;
-  uint8_t buffered_bits;
+  std::size_t used;
 
-  size_type_t<N> mask(std::size_t n) {
-    return (size_type_t<N>(1) << n) - 1;
+  void store(std::uint64_t word, std::size_t n) {
+    if (data.size() < used + n) {
+      data.resize(std::max(used + n, data.size() * 2));
+    }
+    this->store_word(&data[used], word, n);
+    used += n;
+    return;
   }
 
  public:
-  BitsToBytes() = default;
+  BitsToBytes() : data{}, used(0) {
+    return;
+  }
+
+  /// \fn BitsToBytes(std::size_t reserved_bytes)
+  /// \brief Constructor of class BitsToBytes
+  /// \param[in] reserved_bytes expected length of the byte stream
+  explicit BitsToBytes(std::size_t reserved_bytes) : BitsToBytes() {
+    reserve(reserved_bytes);
+    return;
+  }
+
+  /// \fn reserve(std::size_t reserved_bytes)
+  /// \brief allocate the buffer for the byte stream in advance
+  /// \param[in] reserved_bytes expected length of the byte stream
+  void reserve(std::size_t reserved_bytes) {
+    if (data.size() < reserved_bytes) {
+      data.resize(reserved_bytes);
+    }
+    return;
+  }
 
   /// \fn put(size_type_t<N> value, size_t length)
   /// \brief put a bits to the stream
   /// \param[in] value contains bit-stream
-  /// \param[in] length length of the bit-stream
+  /// \param[in] length length of the bit-stream, up to \c 8 * \c N
   void put(size_type_t<N> value, std::size_t length) {
-    value &= mask(length);
-    if (buffered_length + length >= 8) {
-      // | <-   value  -> | <- buffered -> |
-      // | <- rest -> | <-      8       -> |
-      data.push_back(static_cast<uint8_t>(
-            (buffered_bits | (value << buffered_length)) & 0xff));
-      value >>= 8 - buffered_length;
-      buffered_length = length + buffered_length - 8;
-      while (buffered_length >= 8) {
-        data.push_back(static_cast<uint8_t>(value & 0xff));
-        value >>= 8;
-        buffered_length -= 8;
-      }
-      buffered_bits = static_cast<uint8_t>(value & mask(buffered_length));
-    } else {
-      buffered_bits |= value << buffered_length;
-      buffered_length += length;
+    std::uint64_t word = 0;
+    if (this->append(value, length, &word)) {
+      store(word, 8);
     }
     return;
   }
@@ -70,9 +213,7 @@ class BitsToBytes {
   /// \param[in] value contains bit-stream
   /// \param[in] length length of the bit-stream
   void rput(size_type_t<N> value, size_t length) {
-    for (size_t i = 1; i <= length; i++) {
-      put(value >> (length - i), 1);
-    }
+    put(size_type_t<N>(reverse_bits(value, length)), length);
     return;
   }
 
@@ -80,26 +221,177 @@ class BitsToBytes {
   /// \brief seek to byte-boundary with fill-zero
   /// \return returns current buffer as \c std::vector<uint8_t>
   std::vector<uint8_t>& seek_to_byte_boundary() {
-    if (buffered_length != 0) {
-      data.push_back(buffered_bits);
-      buffered_bits = 0;
-      buffered_length = 0;
-    }
+    std::size_t n;
+    auto word = this->drain(&n);
+    store(word, n);
+    data.resize(used);
     return data;
   }
 };
 
+/// \class BitsToBuffer
+/// \brief converts bit stream to byte stream in caller's memory;
+///        nothing is allocated, bytes that do not fit are dropped and
+///        reported by \c overflow(), and the writer can be reset to
+///        write the next block into the same or another buffer.
+/// \tparam Order order of the bits in each byte
+template <std::size_t N, BitOrder Order = BitOrder::LSBFirst>
+class BitsToBuffer : private BitRegister<Order> {
+ private:
+  uint8_t* first;
+  std::size_t capacity, used;
+  bool overflowed;
+
+  void store(std::uint64_t word, std::size_t n) {
+    if (capacity - used < n) {
+      overflowed = true;
+      if (capacity == used) {
+        return;
+      }
+      // keep the bytes that come first in the stream
+      if (Order == BitOrder::MSBFirst) {
+        word >>= (n - (capacity - used)) * 8;
+      }
+      n = capacity - used;
+    }
+    this->store_word(first + used, word, n);
+    used += n;
+    return;
+  }
+
+ public:
+  /// \fn BitsToBuffer(uint8_t* data, std::size_t length)
+  /// \brief Constructor of class BitsToBuffer
+  /// \param[in] data buffer to write the byte stream into
+  /// \param[in] length capacity of the buffer in bytes
+  BitsToBuffer(uint8_t* data, std::size_t length)
+    : first(data), capacity(length), used(0), overflowed(false) {
+    return;
+  }
+
+  /// \fn put(size_type_t<N> value, size_t length)
+  /// \brief put a bits to the stream
+  /// \param[in] value contains bit-stream
+  /// \param[in] length length of the bit-stream, up to \c 8 * \c N
+  void put(size_type_t<N> value, std::size_t length) {
+    std::uint64_t word = 0;
+    if (this->append(value, length, &word)) {
+      store(word, 8);
+    }
+    return;
+  }
+
+  /// \fn rput(size_type_t<N> value, size_t length)
+  /// \brief put a reversed bits to the stream
+  /// \param[in] value contains bit-stream
+  /// \param[in] length length of the bit-stream
+  void rput(size_type_t<N> value, size_t length) {
+    put(size_type_t<N>(reverse_bits(value, length)), length);
+    return;
+  }
+
+  /// \fn seek_to_byte_boundary()
+  /// \brief seek to byte-boundary with fill-zero
+  /// \return number of bytes written to the buffer
+  std::size_t seek_to_byte_boundary() {
+    std::size_t n;
+    auto word = this->drain(&n);
+    store(word, n);
+    return used;
+  }
+
+  /// \fn size()
+  /// \brief number of whole bytes written to the buffer so far
+  std::size_t size() const {
+    return used;
+  }
+
+  /// \fn overflow()
+  /// \brief check whether the stream did not fit in the buffer
+  bool overflow() const {
+    return overflowed;
+  }
+
+  /// \fn reset()
+  /// \brief discard the stream and write again from the start of the buffer
+  void reset() {
+    std::size_t n;
+    this->drain(&n);
+    used = 0;
+    overflowed = false;
+    return;
+  }
+
+  /// \fn reset(uint8_t* data, std::size_t length)
+  /// \brief discard the stream and write into another buffer
+  /// \param[in] data buffer to write the byte stream into
+  /// \param[in] length capacity of the buffer in bytes
+  void reset(uint8_t* data, std::size_t length) {
+    reset();
+    first = data;
+    capacity = length;
+    return;
+  }
+};
+
 /// \class BytesToBits
-/// \brief converts byte stream to bit stream
-template <std::size_t N>
+/// \brief converts byte stream to bit stream;
+///        bits are buffered in a 64-bit register which is refilled
+///        by one 8-byte load.  reading past the end yields zeros and
+///        sets \c overrun().  the bytes are either owned or borrowed
+///        from the caller without copying.
+/// \tparam Order order of the bits in each byte
+template <std::size_t N, BitOrder Order = BitOrder::LSBFirst>
 class BytesToBits {
  private:
   std::vector<uint8_t> buffer;
+  const uint8_t* first;
+  std::size_t size;
   std::size_t data_index, buffered_length;
-  size_type_t<N> buffered_bits;
+  std::uint64_t buffered_bits;
 
-  size_type_t<N> mask(std::size_t n) {
-    return (size_type_t<N>(1) << n) - 1;
+  static std::uint64_t mask(std::size_t n) {
+    return n >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << n) - 1;
+  }
+
+  std::uint64_t byte_at(std::size_t index) const {
+    return index < size ? first[index] : 0;
+  }
+
+  // places a byte following \c length buffered bits;
+  // MSB-first buffers keep the next bit in the most significant position.
+  static std::uint64_t place(std::uint64_t byte, std::size_t length) {
+    if (Order == BitOrder::LSBFirst) {
+      return byte << length;
+    } else {
+      return length <= 56 ? byte << (56 - length) : byte >> (length - 56);
+    }
+  }
+
+  void refill() {
+    if (data_index + 8 <= size) {
+      // | <- 8 bytes loaded -> |
+      // | <- rest -> | <- buffered bits -> |
+      std::uint64_t word = 0;
+      for (std::size_t i = 0; i < 8; i++) {
+        auto shift = Order == BitOrder::LSBFirst ? i * 8 : 56 - i * 8;
+        word |= std::uint64_t(first[data_index + i]) << shift;
+      }
+      if (Order == BitOrder::LSBFirst) {
+        buffered_bits |= word << buffered_length;
+      } else {
+        buffered_bits |= word >> buffered_length;
+      }
+      data_index += (63 - buffered_length) >> 3;
+      buffered_length |= 56;
+    } else {
+      while (buffered_length <= 56) {
+        buffered_bits |= place(byte_at(data_index), buffered_length);
+        buffered_length += 8;
+        data_index++;
+      }
+    }
+    return;
   }
 
  public:
@@ -107,7 +399,12 @@ class BytesToBits {
   /// \brief Constructor of class BytesToBits
   /// \param[in] data buffer that contains bit-stream
   explicit BytesToBits(const std::vector<uint8_t>& data)
-    : buffer(data), data_index(0), buffered_length(0), buffered_bits(0) {
+    : buffer(data),
+      first(buffer.data()),
+      size(buffer.size()),
+      data_index(0),
+      buffered_length(0),
+      buffered_bits(0) {
     return;
   }
 
@@ -116,93 +413,175 @@ class BytesToBits {
   /// \param[in] data buffer that contains bit-stream
   explicit BytesToBits(std::vector<uint8_t>&& data)
     : buffer(std::move(data)),
+      first(buffer.data()),
+      size(buffer.size()),
+      data_index(0),
+      buffered_length(0),
+      buffered_bits(0) {
+    return;
+  }
+
+  /// \fn BytesToBits(const uint8_t* data, std::size_t length)
+  /// \brief Constructor of class BytesToBits;
+  ///        reads the caller's memory, which must outlive the object
+  /// \param[in] data pointer to the bit-stream
+  /// \param[in] length length of the bit-stream in bytes
+  BytesToBits(const uint8_t* data, std::size_t length)
+    : buffer{},
+      first(data),
+      size(length),
       data_index(0),
       buffered_length(0),
       buffered_bits(0) {
     return;
   }
 
+  BytesToBits(const BytesToBits& other)
+    : buffer(other.buffer),
+      first(other.buffer.empty() ? other.first : buffer.data()),
+      size(other.size),
+      data_index(other.data_index),
+      buffered_length(other.buffered_length),
+      buffered_bits(other.buffered_bits) {
+    return;
+  }
+
+  BytesToBits(BytesToBits&&) = default;
+
+  BytesToBits& operator=(const BytesToBits& other) {
+    return *this = BytesToBits(other);
+  }
+
+  BytesToBits& operator=(BytesToBits&&) = default;
+
+  /// \fn peek(std::size_t length)
+  /// \brief look at next bits without removing them from the stream
+  /// \param[in] length length of the bits, up to \c 56
+  /// \return the bits, the first bit in the least significant position
+  ///         for \c LSBFirst and in the most significant one for
+  ///         \c MSBFirst
+  std::uint64_t peek(std::size_t length) {
+    if (buffered_length < length) {
+      refill();
+    }
+    if (Order == BitOrder::LSBFirst) {
+      return buffered_bits & mask(length);
+    } else {
+      return length == 0 ? 0 : buffered_bits >> (64 - length);
+    }
+  }
+
+  /// \fn consume(std::size_t length)
+  /// \brief remove bits from the stream
+  /// \param[in] length length of the bits, up to the last \c peek
+  void consume(std::size_t length) {
+    if (Order == BitOrder::LSBFirst) {
+      buffered_bits >>= length;
+    } else {
+      buffered_bits <<= length;
+    }
+    buffered_length -= length;
+    return;
+  }
+
   /// \fn get(std::size_t length)
   /// \brief get a value from the stream
   size_type_t<N> get(std::size_t length) {
-    if (length > buffered_length) {
-      // | <- buffer -> | <- buffered bits -> |
-      // | <- rest -> | <-      value      -> |
-      auto value = buffered_bits;
-      auto stored_length = buffered_length;
-      length -= buffered_length;
+    if (length <= 56) {
+      auto value = peek(length);
+      consume(length);
+      return size_type_t<N>(value);
+    } else if (Order == BitOrder::LSBFirst) {
+      auto lower = peek(32);
+      consume(32);
+      auto upper = peek(length - 32);
+      consume(length - 32);
+      return size_type_t<N>(lower | upper << 32);
+    } else {
+      auto upper = peek(length - 32);
+      consume(length - 32);
+      auto lower = peek(32);
+      consume(32);
+      return size_type_t<N>(upper << 32 | lower);
+    }
+  }
+
+  /// \fn get_unary()
+  /// \brief get a run of zeros terminated by a one;
+  ///        the run is found by counting zeros of the buffered word and
+  ///        whole zero words are skipped at once
+  /// \return length of the run; the terminating one is consumed too
+  std::size_t get_unary() {
+    std::size_t run = 0;
+    for (;;) {
+      if (buffered_length <= 56) {
+        refill();
+      }
+      auto bits = Order == BitOrder::LSBFirst
+                ? buffered_bits & mask(buffered_length)
+                : buffered_bits & ~mask(64 - buffered_length);
+      if (bits != 0) {
+        auto zeros = Order == BitOrder::LSBFirst ? count_trailing_zeros(bits)
+                                                 : count_leading_zeros(bits);
+        consume(zeros);
+        consume(1);
+        return run + zeros;
+      }
+      run += buffered_length;
       buffered_bits = 0;
       buffered_length = 0;
-      while (length > buffered_length) {
-        buffered_bits |= size_type_t<N>(buffer[data_index]) << buffered_length;
-        buffered_length += 8;
-        data_index++;
+      if (overrun()) {
+        return run;
       }
-      value |= (buffered_bits & mask(length)) << stored_length;
-      buffered_bits >>= length;
-      buffered_length -= length;
-      buffered_bits &= mask(buffered_length);
-      return value;
-    } else {
-      // | <- 0 -> | <-   buffered bits    -> |
-      // |         | <- rest -> | <- value -> |
-      auto value = buffered_bits & mask(length);
-      buffered_length -= length;
-      buffered_bits >>= length;
-      return value;
     }
   }
 
   /// \fn fetch(std::size_t length)
   /// \brief fetch a value from the stream
   size_type_t<N> fetch(std::size_t length) const {
-    if (length > buffered_length) {
-      auto value = buffered_bits;
-      auto stored_length = buffered_length;
-      length -= buffered_length;
-      auto index = data_index;
-      std::size_t extra_read_length = 0;
-      size_type_t<N> extra_buffer = 0;
-      while (length > extra_read_length) {
-        extra_buffer |= size_type_t<N>(buffer[index]) << extra_read_length;
-        extra_read_length += 8;
-        index++;
-      }
-      return value | (extra_buffer & mask(length)) << stored_length;
+    auto value = Order == BitOrder::LSBFirst
+               ? buffered_bits & mask(buffered_length)
+               : buffered_bits & ~mask(64 - buffered_length);
+    auto index = data_index;
+    for (auto stored_length = buffered_length;
+         stored_length < length && stored_length < 64;
+         stored_length += 8) {
+      value |= place(byte_at(index), stored_length);
+      index++;
+    }
+    if (Order == BitOrder::LSBFirst) {
+      return size_type_t<N>(value & mask(length));
     } else {
-      return buffered_bits & mask(length);
+      return size_type_t<N>(length == 0 ? 0 : value >> (64 - length));
     }
   }
 
   /// \fn rget(size_t length)
   /// \brief get a reversed value from the stream
   size_type_t<N> rget(size_t length) {
-    size_type_t<N> ret = 0;
-    for (size_t i = 0; i < length; i++) {
-      ret = (ret << 1) | get(1);
-    }
-    return ret;
+    return size_type_t<N>(reverse_bits(get(length), length));
   }
 
   /// \fn rget(size_t length, size_type_t<N> upper_bits)
   /// \brief get a reversed value from the stream
   size_type_t<N> rget(size_t length, size_type_t<N> upper_bits) {
-    for (size_t i = 0; i < length; i++) {
-      upper_bits = (upper_bits << 1) | get(1);
-    }
-    return upper_bits;
+    auto upper = length >= 64 ? 0 : std::uint64_t(upper_bits) << length;
+    return size_type_t<N>(upper | reverse_bits(get(length), length));
   }
 
   /// \fn seek_to_byte_boundary()
   /// \brief seek to the byte-boundary
   void seek_to_byte_boundary() {
-    if (buffered_length != 0) {
-      buffered_length = 0;
-      buffered_bits = 0;
-      data_index++;
-    }
+    consume(buffered_length % 8);
     return;
   }
+
+  /// \fn overrun()
+  /// \brief check whether bits past the end of the stream were consumed
+  /// \return \c true if zeros after the end of the stream were read
+  bool overrun() const {
+    return data_index * 8 - buffered_length > size * 8;
+  }
 };
 
 }  // namespace ResearchLibrary
@@ -0,0 +1,552 @@
+// Copyright 2015 pixie.grasper
+/// \file block-sorting.h
+/// \brief Implementation of the Block-Sorting Compressor;
+///        BWT, MTF, zero-run coding and multiple Huffman tables,
+///        in the manner of bzip2
+/// \author pixie.grasper
+
+#ifndef INCLUDES_BLOCK_SORTING_H_
+#define INCLUDES_BLOCK_SORTING_H_
+
+/// \privatesection
+int gets();
+/// \publicsection
+#include <cstdint>
+#include <vector>
+#include <array>
+#include <queue>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <map>
+
+#ifdef RESEARCHLIB_OFFLINE_TEST
+#include "./size-type.h"
+#include "./bit-byte-converter.h"
+#include "./huffman-coding.h"
+#include "./burrows-wheeler-transform.h"
+#include "./check-sum.h"
+#else
+#include <size-type.h>
+#include <bit-byte-converter.h>
+#include <huffman-coding.h>
+#include <burrows-wheeler-transform.h>
+#include <check-sum.h>
+#endif
+
+/// \namespace ResearchLibrary
+/// \namespace ResearchLibrary::BlockSorting
+namespace ResearchLibrary {
+namespace BlockSorting {
+
+/// \privatesection
+constexpr std::size_t RUNA = 0, RUNB = 1;
+constexpr std::size_t group_length = 50;
+constexpr std::size_t max_tables = 6;
+constexpr std::size_t max_code_length = 17;
+constexpr std::size_t block_header_length = 12;
+// a block of n bytes takes at most 17 bits per symbol, 6 bits per selector
+// and a few hundred bytes of tables, about 2.2 n bytes in all, so the
+// compressed length of a block of up to 2^30 bytes fits in 4 bytes.
+constexpr std::size_t max_block_size = std::size_t(1) << 30;
+constexpr std::array<std::uint8_t, 4> magic = {{'R', 'L', 'B', 'S'}};
+
+using BitWriter = BitsToBytes<8, BitOrder::MSBFirst>;
+using BitReader = BytesToBits<8, BitOrder::MSBFirst>;
+
+template <typename = int>
+void put_u32(std::vector<std::uint8_t>* buffer, std::size_t value) {
+  for (std::size_t i = 0; i < 4; i++) {
+    buffer->push_back(std::uint8_t(value >> (i * 8)));
+  }
+  return;
+}
+
+template <typename = int>
+std::size_t get_u32(const std::uint8_t* data) {
+  std::size_t value = 0;
+  for (std::size_t i = 0; i < 4; i++) {
+    value |= std::size_t(data[i]) << (i * 8);
+  }
+  return value;
+}
+
+// huffman code lengths for every symbol, none longer than max_length;
+// zero frequencies count as one so that every symbol gets a code, and the
+// frequencies are halved until the longest code fits.
+template <typename = int>
+auto code_lengths(const std::vector<std::size_t>& frequency,
+                  std::size_t max_length) {
+  const auto N = frequency.size();
+  std::vector<std::size_t> weight(N), lengths(N);
+  for (std::size_t i = 0; i < N; i++) {
+    weight[i] = std::max(frequency[i], std::size_t(1));
+  }
+  for (;;) {
+    using Node = std::pair<std::size_t, std::size_t>;
+    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> heap{};
+    std::vector<std::size_t> parent(N * 2 - 1);
+    for (std::size_t i = 0; i < N; i++) {
+      heap.emplace(weight[i], i);
+    }
+    for (auto next = N; heap.size() > 1; next++) {
+      auto first = heap.top();
+      heap.pop();
+      auto second = heap.top();
+      heap.pop();
+      parent[first.second] = parent[second.second] = next;
+      heap.emplace(first.first + second.first, next);
+    }
+    // the root is the last node; parents always come after their children
+    std::vector<std::size_t> depth(N * 2 - 1);
+    for (auto i = N * 2 - 2; i-- > 0;) {
+      depth[i] = depth[parent[i]] + 1;
+    }
+    std::size_t longest = 0;
+    for (std::size_t i = 0; i < N; i++) {
+      lengths[i] = depth[i];
+      longest = std::max(longest, lengths[i]);
+    }
+    if (longest <= max_length) {
+      break;
+    }
+    for (std::size_t i = 0; i < N; i++) {
+      weight[i] = weight[i] / 2 + 1;
+    }
+  }
+  return lengths;
+}
+
+// canonical codes from the lengths, shortest codes first.
+template <typename = int>
+auto canonical_codes(const std::vector<std::size_t>& lengths) {
+  std::vector<std::size_t> codes(lengths.size());
+  std::size_t code = 0;
+  for (std::size_t length = 1; length <= max_code_length; length++) {
+    for (std::size_t i = 0; i < lengths.size(); i++) {
+      if (lengths[i] == length) {
+        codes[i] = code++;
+      }
+    }
+    code <<= 1;
+  }
+  return codes;
+}
+
+// the decoder of the canonical codes of the lengths.
+template <typename = int>
+auto make_decode_table(const std::vector<std::size_t>& lengths) {
+  auto&& codes = canonical_codes(lengths);
+  std::map<std::uint16_t, std::pair<unsigned_integer_t, unsigned_integer_t>>
+      code_map{};
+  for (std::size_t i = 0; i < lengths.size(); i++) {
+    code_map[std::uint16_t(i)] = std::make_pair(lengths[i], codes[i]);
+  }
+  return HuffmanCoding::make_decode_table<BitOrder::MSBFirst>(code_map);
+}
+
+// move-to-front over the bytes in use and zero-run coding of its output;
+// a run of n zeros is n written in bijective base 2 with the digits RUNA
+// and RUNB, the other ranks r are r + 1, and the block ends with EOB.
+template <typename = int>
+auto mtf_and_zero_runs(const std::vector<std::uint8_t>& bwt,
+                       const std::array<std::uint8_t, 256>& ranks,
+                       std::size_t used) {
+  std::vector<std::uint16_t> symbols{};
+  symbols.reserve(bwt.size() + 1);
+  std::array<std::uint8_t, 256> order{};
+  for (std::size_t i = 0; i < used; i++) {
+    order[i] = std::uint8_t(i);
+  }
+  std::size_t zeros = 0;
+  auto flush = [&]() {
+    while (zeros > 0) {
+      zeros--;
+      symbols.push_back(std::uint16_t(zeros & 1 ? RUNB : RUNA));
+      zeros /= 2;
+    }
+    return;
+  };
+  for (std::size_t i = 0; i < bwt.size(); i++) {
+    auto c = ranks[bwt[i]];
+    if (order[0] == c) {
+      zeros++;
+      continue;
+    }
+    flush();
+    std::size_t j = 1;
+    auto moved = order[0];
+    while (order[j] != c) {
+      std::swap(moved, order[j]);
+      j++;
+    }
+    order[j] = moved;
+    order[0] = c;
+    symbols.push_back(std::uint16_t(j + 1));
+  }
+  flush();
+  symbols.push_back(std::uint16_t(used + 1));
+  return symbols;
+}
+
+// bzip2's choice of the number of tables.
+template <typename = int>
+std::size_t number_of_tables(std::size_t symbols) {
+  return symbols < 200 ? 2 : symbols < 600 ? 3 : symbols < 1200 ? 4
+       : symbols < 2400 ? 5 : 6;
+}
+
+// picks the code lengths of the tables and a table for every group of
+// symbols; starts from tables that each cover a slice of the alphabet and
+// refines them by a few rounds of reassigning groups to the cheapest table.
+template <typename = int>
+auto choose_tables(const std::vector<std::uint16_t>& symbols,
+                   std::size_t alphabet_size,
+                   std::vector<std::uint8_t>* selectors) {
+  const auto tables = number_of_tables(symbols.size());
+  const auto groups = (symbols.size() + group_length - 1) / group_length;
+  std::vector<std::size_t> frequency(alphabet_size);
+  for (auto&& symbol : symbols) {
+    frequency[symbol]++;
+  }
+  std::vector<std::vector<std::size_t>> lengths(tables);
+  auto remaining = symbols.size();
+  std::size_t first = 0;
+  for (auto t = tables; t > 0; t--) {
+    auto target = remaining / t;
+    auto last = first;
+    std::size_t sum = 0;
+    while (sum < target && last < alphabet_size) {
+      sum += frequency[last++];
+    }
+    if (last > first + 1 && t != tables && t != 1 && (tables - t) % 2 == 1) {
+      sum -= frequency[--last];
+    }
+    lengths[t - 1].assign(alphabet_size, 15);
+    for (auto v = first; v < last; v++) {
+      lengths[t - 1][v] = 0;
+    }
+    first = last;
+    remaining -= sum;
+  }
+  selectors->resize(groups);
+  for (std::size_t round = 0; round < 4; round++) {
+    std::vector<std::vector<std::size_t>> table_frequency(
+        tables, std::vector<std::size_t>(alphabet_size));
+    for (std::size_t g = 0; g < groups; g++) {
+      auto begin = g * group_length;
+      auto end = std::min(begin + group_length, symbols.size());
+      std::size_t best = 0, best_cost = 0;
+      for (std::size_t t = 0; t < tables; t++) {
+        std::size_t cost = 0;
+        for (auto i = begin; i < end; i++) {
+          cost += lengths[t][symbols[i]];
+        }
+        if (t == 0 || cost < best_cost) {
+          best = t;
+          best_cost = cost;
+        }
+      }
+      (*selectors)[g] = std::uint8_t(best);
+      for (auto i = begin; i < end; i++) {
+        table_frequency[best][symbols[i]]++;
+      }
+    }
+    for (std::size_t t = 0; t < tables; t++) {
+      lengths[t] = code_lengths(table_frequency[t], max_code_length);
+    }
+  }
+  return lengths;
+}
+
+// compresses one block; the 12-byte header holds the length of the block,
+// its CRC-32 and the BWT index, all little endian.
+template <typename = int>
+auto encode_block(const std::uint8_t* first, std::size_t length) {
+  std::vector<std::uint8_t> block(first, first + length);
+  auto&& bwt = BurrowsWheelerTransform
+             ::BWT<BurrowsWheelerTransform::SuffixSorter::InducedSorting>(
+                 block);
+  std::vector<std::uint8_t> ret{};
+  ret.reserve(block_header_length);
+  put_u32(&ret, length);
+  put_u32(&ret, CheckSum::CRC32(block, 0));
+  put_u32(&ret, bwt.second);
+
+  std::array<bool, 256> in_use{};
+  for (auto&& c : block) {
+    in_use[c] = true;
+  }
+  std::array<std::uint8_t, 256> ranks{};
+  std::size_t used = 0;
+  for (std::size_t c = 0; c < 256; c++) {
+    if (in_use[c]) {
+      ranks[c] = std::uint8_t(used++);
+    }
+  }
+  auto&& symbols = mtf_and_zero_runs(bwt.first, ranks, used);
+  std::vector<std::uint8_t> selectors{};
+  auto&& lengths = choose_tables(symbols, used + 2, &selectors);
+
+  BitWriter bits(length / 2);
+  // the bytes in use, as 16 ranges of 16
+  std::size_t ranges = 0;
+  for (std::size_t r = 0; r < 16; r++) {
+    for (std::size_t c = r * 16; c < r * 16 + 16; c++) {
+      if (in_use[c]) {
+        ranges |= std::size_t(1) << (15 - r);
+        break;
+      }
+    }
+  }
+  bits.put(ranges, 16);
+  for (std::size_t r = 0; r < 16; r++) {
+    if (ranges & (std::size_t(1) << (15 - r))) {
+      for (std::size_t c = r * 16; c < r * 16 + 16; c++) {
+        bits.put(in_use[c], 1);
+      }
+    }
+  }
+  // the selectors, move-to-front coded in unary
+  bits.put(lengths.size(), 3);
+  bits.put(selectors.size(), 32);
+  std::array<std::uint8_t, max_tables> order{{0, 1, 2, 3, 4, 5}};
+  for (auto&& selector : selectors) {
+    std::size_t j = 0;
+    while (order[j] != selector) {
+      j++;
+    }
+    std::rotate(order.begin(), order.begin() + std::ptrdiff_t(j),
+                order.begin() + std::ptrdiff_t(j) + 1);
+    bits.put(1, j + 1);
+  }
+  // the code lengths, each as the difference from the previous one
+  for (auto&& table : lengths) {
+    auto current = table[0];
+    bits.put(current, 5);
+    for (auto&& length_of_symbol : table) {
+      for (; current < length_of_symbol; current++) {
+        bits.put(2, 2);
+      }
+      for (; current > length_of_symbol; current--) {
+        bits.put(3, 2);
+      }
+      bits.put(0, 1);
+    }
+  }
+  // the symbols
+  std::vector<std::vector<std::size_t>> codes{};
+  for (auto&& table : lengths) {
+    codes.push_back(canonical_codes(table));
+  }
+  for (std::size_t i = 0; i < symbols.size(); i++) {
+    auto t = selectors[i / group_length];
+    bits.put(codes[t][symbols[i]], lengths[t][symbols[i]]);
+  }
+  auto&& stream = bits.seek_to_byte_boundary();
+  ret.insert(ret.end(), stream.begin(), stream.end());
+  return ret;
+}
+
+// decompresses one block into ret; returns false if it is broken.
+template <typename = int>
+bool decode_block(const std::uint8_t* data,
+                  std::size_t size,
+                  std::vector<std::uint8_t>* ret) {
+  if (size < block_header_length) {
+    return false;
+  }
+  const auto length = get_u32(data);
+  const auto crc = get_u32(data + 4);
+  const auto index = get_u32(data + 8);
+  if (length == 0 || index >= length) {
+    return false;
+  }
+  BitReader bits(data + block_header_length, size - block_header_length);
+  std::array<std::uint8_t, 256> bytes{};
+  std::size_t used = 0;
+  auto ranges = bits.get(16);
+  for (std::size_t r = 0; r < 16; r++) {
+    if (ranges & (std::size_t(1) << (15 - r))) {
+      for (std::size_t c = r * 16; c < r * 16 + 16; c++) {
+        if (bits.get(1)) {
+          bytes[used++] = std::uint8_t(c);
+        }
+      }
+    }
+  }
+  const auto alphabet_size = used + 2;
+  const auto tables = std::size_t(bits.get(3));
+  const auto groups = std::size_t(bits.get(32));
+  if (used == 0 || tables < 2 || tables > max_tables ||
+      groups > (length + group_length) / group_length) {
+    return false;
+  }
+  std::vector<std::uint8_t> selectors(groups);
+  std::array<std::uint8_t, max_tables> order{{0, 1, 2, 3, 4, 5}};
+  for (auto&& selector : selectors) {
+    auto j = bits.get_unary();
+    if (j >= tables || bits.overrun()) {
+      return false;
+    }
+    selector = order[j];
+    std::rotate(order.begin(), order.begin() + std::ptrdiff_t(j),
+                order.begin() + std::ptrdiff_t(j) + 1);
+  }
+  std::vector<HuffmanCoding::DecodeTable<std::uint16_t>> decode_tables{};
+  for (std::size_t t = 0; t < tables; t++) {
+    std::vector<std::size_t> lengths(alphabet_size);
+    auto current = std::size_t(bits.get(5));
+    for (auto&& length_of_symbol : lengths) {
+      while (bits.get(1) && current <= max_code_length) {
+        current = bits.get(1) ? current - 1 : current + 1;
+      }
+      if (current == 0 || current > max_code_length || bits.overrun()) {
+        return false;
+      }
+      length_of_symbol = current;
+    }
+    decode_tables.push_back(make_decode_table(lengths));
+  }
+
+  // the symbols, back through the zero runs and the move-to-front
+  std::vector<std::uint8_t> bwt(length);
+  std::array<std::uint8_t, 256> mtf{};
+  for (std::size_t i = 0; i < used; i++) {
+    mtf[i] = bytes[i];
+  }
+  std::size_t written = 0, run = 0, weight = 1;
+  for (std::size_t i = 0;; i++) {
+    if (i / group_length >= groups || bits.overrun()) {
+      return false;
+    }
+    auto&& entry = HuffmanCoding::decode_symbol(
+        &bits, decode_tables[selectors[i / group_length]]);
+    if (entry.length == 0) {
+      return false;
+    }
+    if (entry.value <= RUNB) {
+      run += weight << entry.value;
+      weight <<= 1;
+      if (run > length - written) {
+        return false;
+      }
+      continue;
+    }
+    std::fill(&bwt[0] + written, &bwt[0] + written + run, mtf[0]);
+    written += run;
+    run = 0;
+    weight = 1;
+    if (entry.value == alphabet_size - 1) {
+      break;
+    } else if (written == length) {
+      return false;
+    }
+    auto j = std::size_t(entry.value) - 1;
+    auto c = mtf[j];
+    std::copy_backward(&mtf[0], &mtf[0] + j, &mtf[0] + j + 1);
+    mtf[0] = c;
+    bwt[written++] = c;
+  }
+  if (written != length) {
+    return false;
+  }
+  *ret = BurrowsWheelerTransform::IBWT(bwt, index);
+  return CheckSum::CRC32(*ret, 0) == crc;
+}
+
+/// \publicsection
+/// \fn Encode(const std::vector<std::uint8_t>& source,
+///            std::size_t block_size,
+///            std::size_t threads)
+/// \brief Block-Sorting Compress Function;
+///        every block goes through BWT, move-to-front, zero-run coding
+///        and up to six Huffman tables switched every 50 symbols.
+///        the container is the magic "RLBS", then for each block its
+///        compressed length as 4 bytes little endian followed by the block,
+///        and 4 zero bytes at the end.  the blocks are independent, so
+///        they are compressed and decompressed in parallel.
+/// \param[in] source sequence
+/// \param[in] block_size length of the blocks, up to \c 2^30 so that
+///            the compressed length of every block fits in 4 bytes
+/// \param[in] threads number of threads, \c 0 for one per hardware thread
+/// \return compressed sequence as \c std::vector<std::uint8_t>
+template <typename = int>
+auto Encode(const std::vector<std::uint8_t>& source,
+            std::size_t block_size = 900000,
+            std::size_t threads = 1) {
+  block_size = std::max(std::min(block_size, max_block_size),
+                        std::size_t(1));
+  const auto blocks = (source.size() + block_size - 1) / block_size;
+  threads = std::min(BurrowsWheelerTransform::number_of_threads(threads),
+                     std::max(blocks, std::size_t(1)));
+  std::vector<std::vector<std::uint8_t>> encoded(blocks);
+  BurrowsWheelerTransform::run_in_parallel(threads, [&](std::size_t t) {
+    for (auto b = t; b < blocks; b += threads) {
+      auto first = b * block_size;
+      encoded[b] = encode_block(source.data() + first,
+                                std::min(block_size, source.size() - first));
+    }
+    return;
+  });
+  std::vector<std::uint8_t> ret(magic.begin(), magic.end());
+  for (auto&& block : encoded) {
+    put_u32(&ret, block.size());
+    ret.insert(ret.end(), block.begin(), block.end());
+  }
+  put_u32(&ret, 0);
+  return ret;
+}
+
+/// \fn Decode(const std::vector<std::uint8_t>& data, std::size_t threads)
+/// \brief Block-Sorting Decompress Function
+/// \param[in] data compressed sequence
+/// \param[in] threads number of threads, \c 0 for one per hardware thread
+/// \return decompressed sequence as \c std::vector<std::uint8_t>;
+///         empty if the data is broken
+template <typename = int>
+auto Decode(const std::vector<std::uint8_t>& data, std::size_t threads = 1) {
+  std::vector<std::uint8_t> ret{};
+  if (data.size() < magic.size() ||
+      !std::equal(magic.begin(), magic.end(), data.begin())) {
+    return ret;
+  }
+  std::vector<std::pair<std::size_t, std::size_t>> blocks{};
+  for (auto position = magic.size();;) {
+    if (data.size() - position < 4) {
+      return ret;
+    }
+    auto size = get_u32(&data[position]);
+    position += 4;
+    if (size == 0) {
+      break;
+    } else if (data.size() - position < size) {
+      return ret;
+    }
+    blocks.emplace_back(position, size);
+    position += size;
+  }
+  threads = std::min(BurrowsWheelerTransform::number_of_threads(threads),
+                     std::max(blocks.size(), std::size_t(1)));
+  std::vector<std::vector<std::uint8_t>> decoded(blocks.size());
+  std::vector<std::uint8_t> broken(threads);
+  BurrowsWheelerTransform::run_in_parallel(threads, [&](std::size_t t) {
+    for (auto b = t; b < blocks.size() && !broken[t]; b += threads) {
+      broken[t] = !decode_block(&data[blocks[b].first], blocks[b].second,
+                                &decoded[b]);
+    }
+    return;
+  });
+  if (std::find(broken.begin(), broken.end(), 1) != broken.end()) {
+    return ret;
+  }
+  for (auto&& block : decoded) {
+    ret.insert(ret.end(), block.begin(), block.end());
+  }
+  return ret;
+}
+
+}  // namespace BlockSorting
+}  // namespace ResearchLibrary
+
+#endif  // INCLUDES_BLOCK_SORTING_H_
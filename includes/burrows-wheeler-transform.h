@@ -10,9 +10,20 @@
 int gets();
 /// \publicsection
 #include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
 #include <vector>
 #include <utility>
 #include <algorithm>
+#include <atomic>
+#include <thread>
+
+#ifdef RESEARCHLIB_OFFLINE_TEST
+#include "./size-type.h"
+#else
+#include <size-type.h>
+#endif
 
 /// \namespace ResearchLibrary
 /// \namespace ResearchLibrary::BurrowsWheelerTransform
@@ -29,22 +40,50 @@ bool ge(T x, T y) {
   }
 }
 
-template <typename T>
-auto suffix_sort_for_BWT(const std::vector<T>& source) {
-  constexpr auto SORTED_FLAG = std::size_t(1) << (sizeof(std::size_t) * 8 - 1);
-  constexpr auto MASK = ~SORTED_FLAG;
+// equal rotations exist only if the source is a repetition of a shorter
+// sequence; they then come in blocks of N / period, which are put in the
+// ascending order of their position so that every sorter agrees.
+template <typename T, typename Index>
+void order_equal_rotations(const std::vector<T>& source,
+                           std::vector<Index>* sorted) {
   const auto N = source.size();
-  std::vector<std::size_t> I(N), V(N);
-  for (std::size_t i = 0; i < N; i++) {
+  std::vector<Index> border(N);
+  for (std::size_t i = 1; i < N; i++) {
+    auto k = std::size_t(border[i - 1]);
+    while (k > 0 && source[i] != source[k]) {
+      k = border[k - 1];
+    }
+    border[i] = Index(source[i] == source[k] ? k + 1 : k);
+  }
+  auto period = N - border[N - 1];
+  if (period == N || N % period != 0) {
+    return;
+  }
+  for (auto it = sorted->begin(); it != sorted->end();) {
+    auto next = it + std::ptrdiff_t(N / period);
+    std::sort(it, next);
+    it = next;
+  }
+  return;
+}
+
+template <typename T, typename Index = std::size_t>
+auto suffix_sort_for_BWT(const std::vector<T>& source) {
+  constexpr auto SORTED_FLAG = Index(Index(1) << (sizeof(Index) * 8 - 1));
+  constexpr auto MASK = Index(~SORTED_FLAG);
+  const auto N = Index(source.size());
+  std::vector<Index> I(N), V(N);
+  for (Index i = 0; i < N; i++) {
     I[i] = i;
   }
-  std::stable_sort(I.begin(), I.end(), [=](std::size_t x, std::size_t y) {
-    return source[x] < source[y];
+  // same order as the stable sort, but without its N-element buffer
+  std::sort(I.begin(), I.end(), [&](Index x, Index y) {
+    return source[x] < source[y] || (!(source[y] < source[x]) && x < y);
   });
   {
-    auto last_character = source[I[0]];
-    std::size_t g = 0;
-    for (std::size_t i = N - 1; ge(i, decltype(i)(0)); i--) {
+    auto last_character = source[I[N - 1]];
+    auto g = Index(N - 1);
+    for (auto i = Index(N - 1); ge(i, Index(0)); i--) {
       if (last_character != source[I[i]]) {
         g = i;
         last_character = source[I[i]];
@@ -52,16 +91,16 @@ auto suffix_sort_for_BWT(const std::vector<T>& source) {
       V[I[i]] = g;
     }
   }
-  for (std::size_t i = 0; i < N;) {
+  for (Index i = 0; i < N;) {
     auto group = V[I[i]];
     if (i == group) {
       I[i] = SORTED_FLAG + 1;
     }
-    i = group + 1;
+    i = Index(group + 1);
   }
-  std::size_t h = 1;
+  Index h = 1;
   while (h <= N) {
-    std::size_t first_position = 0, group_start_index = 0;
+    Index first_position = 0, group_start_index = 0;
     bool sorted_sequence = false;
     do {
       if ((I[first_position] & SORTED_FLAG) != 0) {
@@ -69,17 +108,17 @@ auto suffix_sort_for_BWT(const std::vector<T>& source) {
           group_start_index = first_position;
           sorted_sequence = true;
         }
-        first_position += I[first_position] & MASK;
+        first_position = Index(first_position + (I[first_position] & MASK));
       } else {
         if (sorted_sequence) {
-          I[group_start_index] = SORTED_FLAG
-                               + (first_position - group_start_index);
+          I[group_start_index] = Index(SORTED_FLAG
+                                       + (first_position - group_start_index));
           sorted_sequence = false;
         }
         auto last_position = V[I[first_position]];
         std::sort(&I[first_position],
                   &I[last_position] + 1,
-                  [=](std::size_t x, std::size_t y) {
+                  [&](Index x, Index y) {
           return V[(x + h) % N] < V[(y + h) % N];
         });
         auto group = last_position;
@@ -101,46 +140,585 @@ auto suffix_sort_for_BWT(const std::vector<T>& source) {
         if (group == first_position) {
           I[group] = SORTED_FLAG + 1;
         }
-        first_position = last_position + 1;
+        first_position = Index(last_position + 1);
       }
     } while (first_position < N);
     if (sorted_sequence) {
-      I[group_start_index] = SORTED_FLAG + (first_position - group_start_index);
+      I[group_start_index] = Index(SORTED_FLAG
+                                   + (first_position - group_start_index));
     }
-    h <<= 1;
+    if (h > N / 2) {
+      break;
+    }
+    h = Index(h << 1);
   }
 
-  for (std::size_t i = 0; i < N; i++) {
+  // rotations left in a group are equal; give each its own position
+  for (Index first_position = 0; first_position < N;) {
+    if ((I[first_position] & SORTED_FLAG) != 0) {
+      first_position = Index(first_position + (I[first_position] & MASK));
+    } else {
+      auto last_position = V[I[first_position]];
+      for (auto i = first_position; i <= last_position; i++) {
+        V[I[i]] = i;
+      }
+      first_position = Index(last_position + 1);
+    }
+  }
+  for (Index i = 0; i < N; i++) {
     I[V[i]] = i;
   }
+  V.clear();
+  V.shrink_to_fit();
+  order_equal_rotations(source, &I);
+  return I;
+}
+
+// SA-IS, the induced sorting of Nong, Zhang and Chan.
+// \c s holds characters in [0, K); returns the suffix array of \c s
+// as if it were terminated by a sentinel smaller than every character.
+template <typename Index>
+auto suffix_array_by_induced_sorting(const std::vector<Index>& s, Index K) {
+  constexpr auto EMPTY = std::numeric_limits<Index>::max();
+  const auto N = Index(s.size());
+  std::vector<Index> SA(N);
+  if (N <= 2) {
+    for (Index i = 0; i < N; i++) {
+      SA[i] = i;
+    }
+    if (N == 2 && s[1] <= s[0]) {
+      std::swap(SA[0], SA[1]);
+    }
+    return SA;
+  }
+
+  // S-type if the suffix is smaller than the next one
+  std::vector<bool> is_s(N);
+  for (auto i = N - 1; i-- > 0;) {
+    is_s[i] = s[i] == s[i + 1] ? is_s[i + 1] : s[i] < s[i + 1];
+  }
+  // start of the L-part and of the S-part of each bucket
+  std::vector<Index> l_start(K + 1), s_start(K + 1);
+  for (Index i = 0; i < N; i++) {
+    if (is_s[i]) {
+      l_start[s[i] + 1]++;
+    } else {
+      s_start[s[i]]++;
+    }
+  }
+  for (Index c = 0; c < K; c++) {
+    s_start[c] += l_start[c];
+    l_start[c + 1] += s_start[c];
+  }
+  s_start[K] += l_start[K];
+
+  std::vector<Index> bucket(K + 1);
+  auto induce = [&](const std::vector<Index>& lms) {
+    std::fill(SA.begin(), SA.end(), EMPTY);
+    std::copy(s_start.begin(), s_start.end(), bucket.begin());
+    for (auto&& i : lms) {
+      SA[bucket[s[i]]++] = i;
+    }
+    std::copy(l_start.begin(), l_start.end(), bucket.begin());
+    SA[bucket[s[N - 1]]++] = Index(N - 1);
+    for (Index i = 0; i < N; i++) {
+      auto j = SA[i];
+      if (j != EMPTY && j >= 1 && !is_s[j - 1]) {
+        SA[bucket[s[j - 1]]++] = Index(j - 1);
+      }
+    }
+    std::copy(l_start.begin(), l_start.end(), bucket.begin());
+    for (auto i = N; i-- > 0;) {
+      auto j = SA[i];
+      if (j != EMPTY && j >= 1 && is_s[j - 1]) {
+        SA[--bucket[s[j - 1] + 1]] = Index(j - 1);
+      }
+    }
+    return;
+  };
+
+  // sort the LMS-substrings
+  std::vector<Index> lms{}, lms_index(N, EMPTY);
+  for (Index i = 1; i < N; i++) {
+    if (!is_s[i - 1] && is_s[i]) {
+      lms_index[i] = Index(lms.size());
+      lms.push_back(i);
+    }
+  }
+  induce(lms);
+  const auto M = Index(lms.size());
+  if (M == 0) {
+    return SA;
+  }
+
+  // name them and sort the reduced string recursively
+  std::vector<Index> sorted_lms{};
+  sorted_lms.reserve(M);
+  for (auto&& i : SA) {
+    if (lms_index[i] != EMPTY) {
+      sorted_lms.push_back(i);
+    }
+  }
+  std::vector<Index> reduced(M);
+  Index name = 0;
+  reduced[lms_index[sorted_lms[0]]] = 0;
+  for (Index k = 1; k < M; k++) {
+    auto l = sorted_lms[k - 1], r = sorted_lms[k];
+    auto l_end = lms_index[l] + 1 < M ? lms[lms_index[l] + 1] : N;
+    auto r_end = lms_index[r] + 1 < M ? lms[lms_index[r] + 1] : N;
+    bool same = l_end - l == r_end - r;
+    if (same) {
+      for (; l < l_end && s[l] == s[r]; l++, r++) {}
+      same = l < N && r < N && s[l] == s[r];
+    }
+    if (!same) {
+      name++;
+    }
+    reduced[lms_index[sorted_lms[k]]] = name;
+  }
+  lms_index.clear();
+  lms_index.shrink_to_fit();
+  auto reduced_SA = suffix_array_by_induced_sorting(reduced, Index(name + 1));
+  for (Index k = 0; k < M; k++) {
+    sorted_lms[k] = lms[reduced_SA[k]];
+  }
+  induce(sorted_lms);
+  return SA;
+}
+
+// ranks small integers through a table of the values that occur, in one
+// pass over the source and one over the table.
+template <typename T, typename Index>
+std::vector<T> symbol_ranks(const std::vector<T>& source,
+                            std::vector<Index>* ranks,
+                            std::true_type) {
+  const auto lowest = std::int64_t(std::numeric_limits<T>::min());
+  std::vector<Index> table(std::size_t(1) << (sizeof(T) * 8));
+  for (auto&& c : source) {
+    table[std::size_t(std::int64_t(c) - lowest)] = 1;
+  }
+  std::vector<T> alphabet{};
+  for (std::size_t v = 0; v < table.size(); v++) {
+    if (table[v] != 0) {
+      table[v] = Index(alphabet.size());
+      alphabet.push_back(T(std::int64_t(v) + lowest));
+    }
+  }
+  for (std::size_t i = 0; i < source.size(); i++) {
+    (*ranks)[i] = table[std::size_t(std::int64_t(source[i]) - lowest)];
+  }
+  return alphabet;
+}
+
+// ranks anything else by a binary search in the sorted alphabet.
+template <typename T, typename Index>
+std::vector<T> symbol_ranks(const std::vector<T>& source,
+                            std::vector<Index>* ranks,
+                            std::false_type) {
+  std::vector<T> alphabet(source);
+  std::sort(alphabet.begin(), alphabet.end());
+  alphabet.erase(std::unique(alphabet.begin(), alphabet.end()),
+                 alphabet.end());
+  for (std::size_t i = 0; i < source.size(); i++) {
+    (*ranks)[i] = Index(std::lower_bound(alphabet.begin(), alphabet.end(),
+                                         source[i]) - alphabet.begin());
+  }
+  return alphabet;
+}
+
+// (*ranks)[i] is the rank of source[i] among the distinct symbols;
+// returns the distinct symbols in ascending order.  ranks holds at least
+// source.size() elements.
+template <typename T, typename Index>
+std::vector<T> symbol_ranks(const std::vector<T>& source,
+                            std::vector<Index>* ranks) {
+  using is_small = std::integral_constant<bool, std::is_integral<T>::value
+                                                && sizeof(T) <= 2>;
+  return symbol_ranks(source, ranks, is_small());
+}
+
+// sorts the rotations of \c source by the suffixes of \c source twice,
+// which gives the same order as \c suffix_sort_for_BWT
+template <typename T, typename Index = std::size_t>
+auto rotation_sort_by_induced_sorting(const std::vector<T>& source) {
+  const auto N = Index(source.size());
+  std::vector<Index> doubled(std::size_t(N) * 2);
+  const auto K = symbol_ranks(source, &doubled).size();
+  std::copy(doubled.begin(), doubled.begin() + std::ptrdiff_t(N),
+            doubled.begin() + std::ptrdiff_t(N));
+  auto&& SA = suffix_array_by_induced_sorting(doubled, Index(K));
+  doubled.clear();
+  doubled.shrink_to_fit();
+  std::vector<Index> ret{};
+  ret.reserve(N);
+  for (auto&& i : SA) {
+    if (i < N) {
+      ret.push_back(i);
+    }
+  }
+  order_equal_rotations(source, &ret);
+  return ret;
+}
+
+// runs task(0), ..., task(threads - 1), each in its own thread.
+template <typename Task>
+void run_in_parallel(std::size_t threads, Task task) {
+  std::vector<std::thread> workers{};
+  for (std::size_t k = 1; k < threads; k++) {
+    workers.emplace_back(task, k);
+  }
+  task(std::size_t(0));
+  for (std::size_t k = 0; k < workers.size(); k++) {
+    workers[k].join();
+  }
+  return;
+}
+
+// prefix doubling of Manber and Myers over all threads; the rotations are
+// bucketed in parallel by their first two characters, then in each round
+// the unsorted groups are refined independently by the rank of the
+// rotation h characters ahead.  returns the same order as
+// \c suffix_sort_for_BWT.
+template <typename T, typename Index = std::size_t>
+auto parallel_suffix_sort_for_BWT(const std::vector<T>& source,
+                                  std::size_t threads) {
+  // a single thread is better off with the serial sorter
+  if (threads <= 1) {
+    return suffix_sort_for_BWT<T, Index>(source);
+  }
+  const auto N = Index(source.size());
+  std::vector<Index> rank(N);
+  const auto K = symbol_ranks(source, &rank).size();
+  constexpr std::size_t maximum_buckets = std::size_t(1) << 16;
+  if (K > maximum_buckets) {
+    return suffix_sort_for_BWT<T, Index>(source);
+  }
+  const std::size_t width = K * K <= maximum_buckets ? 2 : 1;
+  const auto buckets = width == 2 ? K * K : K;
+  auto chunk_length = std::size_t(N) / threads + 1;
+  auto chunk = [=](std::size_t k) {
+    return std::make_pair(std::min(std::size_t(N), k * chunk_length),
+                          std::min(std::size_t(N), (k + 1) * chunk_length));
+  };
+
+  // radix bucketing by the first characters
+  auto key = [&](std::size_t i) {
+    return width == 2 ? rank[i] * K + rank[(i + 1) % N] : std::size_t(rank[i]);
+  };
+  std::vector<std::vector<Index>> counts(threads,
+                                         std::vector<Index>(buckets));
+  run_in_parallel(threads, [&](std::size_t k) {
+    for (auto i = chunk(k).first; i < chunk(k).second; i++) {
+      counts[k][key(i)]++;
+    }
+    return;
+  });
+  std::vector<Index> bucket_limit(buckets);
+  Index position = 0;
+  for (std::size_t b = 0; b < buckets; b++) {
+    for (std::size_t k = 0; k < threads; k++) {
+      auto count = counts[k][b];
+      counts[k][b] = position;
+      position = Index(position + count);
+    }
+    bucket_limit[b] = position;
+  }
+  std::vector<Index> I(N), V(N);
+  run_in_parallel(threads, [&](std::size_t k) {
+    for (auto i = chunk(k).first; i < chunk(k).second; i++) {
+      auto b = key(i);
+      I[counts[k][b]++] = Index(i);
+      V[i] = Index(bucket_limit[b] - 1);
+    }
+    return;
+  });
+  counts.clear();
+  rank.clear();
+  rank.shrink_to_fit();
+  std::vector<std::pair<Index, Index>> groups{};
+  for (std::size_t b = 0; b < buckets; b++) {
+    auto first = b == 0 ? 0 : bucket_limit[b - 1];
+    if (bucket_limit[b] - first > 1) {
+      groups.emplace_back(first, Index(bucket_limit[b] - 1));
+    }
+  }
+  bucket_limit.clear();
+  bucket_limit.shrink_to_fit();
+
+  // refine the groups, reading the ranks of the previous round
+  std::vector<Index> next_V(N);
+  for (auto h = width; !groups.empty() && h < N; h *= 2) {
+    run_in_parallel(threads, [&](std::size_t k) {
+      std::copy(V.begin() + std::ptrdiff_t(chunk(k).first),
+                V.begin() + std::ptrdiff_t(chunk(k).second),
+                next_V.begin() + std::ptrdiff_t(chunk(k).first));
+      return;
+    });
+    std::atomic<std::size_t> next_group(0);
+    std::vector<std::vector<std::pair<Index, Index>>> subgroups(threads);
+    run_in_parallel(threads, [&](std::size_t k) {
+      for (auto g = next_group++; g < groups.size(); g = next_group++) {
+        auto first = groups[g].first, last = groups[g].second;
+        auto rank_of = [&](Index i) {
+          return V[(std::size_t(i) + h) % N];
+        };
+        std::sort(&I[first], &I[last] + 1, [&](Index x, Index y) {
+          return rank_of(x) < rank_of(y);
+        });
+        for (auto i = last + std::size_t(1); i-- > first;) {
+          auto end = i;
+          for (; i > first && rank_of(I[i - 1]) == rank_of(I[end]); i--) {}
+          for (auto j = i; j <= end; j++) {
+            next_V[I[j]] = Index(end);
+          }
+          if (i != end) {
+            subgroups[k].emplace_back(Index(i), Index(end));
+          }
+        }
+      }
+      return;
+    });
+    std::swap(V, next_V);
+    groups.clear();
+    for (auto&& list : subgroups) {
+      groups.insert(groups.end(), list.begin(), list.end());
+    }
+  }
+  V.clear();
+  V.shrink_to_fit();
+  next_V.clear();
+  next_V.shrink_to_fit();
+  order_equal_rotations(source, &I);
   return I;
 }
 
+/// \publicsection
+/// \enum SuffixSorter
+/// \brief algorithm that sorts the rotations in \c BWT;
+///        \c LarssonSadakane is the prefix doubling, O(N log N) time,
+///        \c InducedSorting is SA-IS, O(N) time, and
+///        \c ParallelPrefixDoubling is the prefix doubling on several
+///        threads, used by \c ParallelBWT
+enum class SuffixSorter {
+  LarssonSadakane,
+  InducedSorting,
+  ParallelPrefixDoubling,
+};
+
+/// \privatesection
+// the k restart points of a block of N are the rows at which the inverse
+// transform emits the positions floor(j * N / k) for j = 0, ..., k - 1;
+// split so as not to overflow while k fits in 32 bits.
+template <typename = int>
+std::size_t restart_position(std::size_t j, std::size_t N, std::size_t k) {
+  return j * (N / k) + j * (N % k) / k;
+}
+
+template <SuffixSorter Sorter, typename Index, typename T>
+auto BWT_with_index_type(const std::vector<T>& source,
+                         std::size_t threads,
+                         std::vector<std::size_t>* restarts) {
+  auto&& suffix_array
+      = Sorter == SuffixSorter::InducedSorting
+      ? rotation_sort_by_induced_sorting<T, Index>(source)
+      : Sorter == SuffixSorter::ParallelPrefixDoubling
+      ? parallel_suffix_sort_for_BWT<T, Index>(source, threads)
+      : suffix_sort_for_BWT<T, Index>(source);
+  const auto N = source.size();
+  const auto k = restarts->size();
+  std::vector<bool> sampled(k == 0 ? 0 : N);
+  for (std::size_t j = 0; j < k; j++) {
+    sampled[restart_position(j, N, k)] = true;
+  }
+  std::vector<std::pair<std::size_t, std::size_t>> samples;
+  samples.reserve(k);
+  std::size_t index = 0;
+  std::vector<T> ret(N);
+  for (std::size_t i = 0; i < N; i++) {
+    // row i emits the position just before its rotation
+    auto position = suffix_array[i] == 0 ? N - 1 : suffix_array[i] - 1;
+    if (suffix_array[i] == 0) {
+      index = i;
+    }
+    ret[i] = source[position];
+    if (k != 0 && sampled[position]) {
+      samples.emplace_back(position, i);
+    }
+  }
+  std::sort(samples.begin(), samples.end());
+  for (std::size_t j = 0; j < k; j++) {
+    (*restarts)[j] = samples[j].second;
+  }
+  return std::make_pair(std::move(ret), index);
+}
+
+template <SuffixSorter Sorter, typename T>
+auto sorted_BWT(const std::vector<T>& source,
+                std::size_t threads,
+                std::vector<std::size_t>* restarts) {
+  if (source.size() <= 1) {
+    restarts->assign(std::min(restarts->size(), source.size()), 0);
+    return std::make_pair(source, static_cast<std::size_t>(0));
+  } else if (source.size() < (std::size_t(1) << 31)) {
+    // the sorters need one spare bit in the index
+    return BWT_with_index_type<Sorter, size_type_t<4>>(source, threads,
+                                                       restarts);
+  } else {
+    return BWT_with_index_type<Sorter, size_type_t<8>>(source, threads,
+                                                       restarts);
+  }
+}
+
+template <typename = int>
+std::size_t number_of_threads(std::size_t threads) {
+  if (threads == 0) {
+    threads = std::max(std::size_t(std::thread::hardware_concurrency()),
+                       std::size_t(1));
+  }
+  return threads;
+}
+
 /// \publicsection
 /// \fn BWT(const std::vector<T>& source)
-/// \brief Burrows-Wheeler Transform Function
+/// \brief Burrows-Wheeler Transform Function;
+///        blocks shorter than 2 GiB are sorted with 32-bit indices
 /// \param[in] source sequence
+/// \tparam Sorter algorithm that sorts the rotations
 /// \return \c std::pair of
 ///         sorted sequence as \c std::vector<T> and index as \c std::size_t
-template <typename T>
+template <SuffixSorter Sorter = SuffixSorter::LarssonSadakane, typename T>
 auto BWT(const std::vector<T>& source) {
-  if (source.size() == 0) {
-    return std::make_pair(std::vector<T>(), static_cast<std::size_t>(0));
-  } else if (source.size() == 1) {
-    return std::make_pair(source, static_cast<std::size_t>(0));
+  std::vector<std::size_t> restarts{};
+  return sorted_BWT<Sorter>(source, 1, &restarts);
+}
+
+/// \fn ParallelBWT(const std::vector<T>& source, std::size_t threads)
+/// \brief Burrows-Wheeler Transform Function sorting on several threads;
+///        the result equals that of \c BWT
+/// \param[in] source sequence
+/// \param[in] threads number of threads, \c 0 for one per hardware thread;
+///            one thread sorts as \c BWT does
+/// \return \c std::pair of
+///         sorted sequence as \c std::vector<T> and index as \c std::size_t
+template <typename T>
+auto ParallelBWT(const std::vector<T>& source, std::size_t threads = 0) {
+  std::vector<std::size_t> restarts{};
+  return sorted_BWT<SuffixSorter::ParallelPrefixDoubling>(
+      source, number_of_threads(threads), &restarts);
+}
+
+/// \fn SampledBWT(const std::vector<T>& source, std::size_t samples)
+/// \brief Burrows-Wheeler Transform Function that also records restart
+///        points, from which \c IBWT can run independent walks
+/// \param[in] source sequence
+/// \param[in] samples number of restart points,
+///            up to the length and to 2^32 - 1
+/// \tparam Sorter algorithm that sorts the rotations
+/// \return \c std::pair of the result of \c BWT and the restart points
+///         as \c std::vector<std::size_t>
+template <SuffixSorter Sorter = SuffixSorter::LarssonSadakane, typename T>
+auto SampledBWT(const std::vector<T>& source, std::size_t samples) {
+  std::vector<std::size_t> restarts(std::min({
+      samples, source.size(),
+      std::size_t(std::numeric_limits<std::uint32_t>::max())}));
+  auto&& bwt = sorted_BWT<Sorter>(source, 1, &restarts);
+  return std::make_pair(std::move(bwt), std::move(restarts));
+}
+
+/// \privatesection
+// next[i] is the row whose rotation follows that of row i; built by one
+// counting pass in place of the stable sort of the rows by character.
+template <typename Index, typename T>
+auto next_rows(const std::vector<T>& source) {
+  const auto N = source.size();
+  std::vector<Index> next(N);
+  std::vector<Index> ranks(N);
+  std::vector<Index> start(symbol_ranks(source, &ranks).size() + 1);
+  for (std::size_t i = 0; i < N; i++) {
+    start[ranks[i] + std::size_t(1)]++;
   }
-  auto&& suffix_array = suffix_sort_for_BWT(source);
-  std::size_t index;
-  std::vector<T> ret(source.size());
-  for (std::size_t i = 0; i < suffix_array.size(); i++) {
-    if (suffix_array[i] == 0) {
-      index = i;
+  for (std::size_t c = 1; c < start.size(); c++) {
+    start[c] = Index(start[c] + start[c - 1]);
+  }
+  for (std::size_t i = 0; i < N; i++) {
+    next[start[ranks[i]]++] = Index(i);
+  }
+  return next;
+}
+
+// walks from the restart points \c first, ..., \c last - 1 interleaved,
+// so that the cache misses of the independent walks overlap.
+template <typename Index, typename T>
+void walk_from_restarts(const std::vector<T>& source,
+                        const std::vector<Index>& next,
+                        const std::vector<std::size_t>& restarts,
+                        std::size_t first,
+                        std::size_t last,
+                        std::vector<T>* ret) {
+  const auto N = source.size();
+  const auto k = restarts.size();
+  std::vector<std::size_t> rows(&restarts[first], &restarts[last - 1] + 1);
+  std::vector<std::size_t> positions(last - first), ends(last - first);
+  for (auto j = first; j < last; j++) {
+    positions[j - first] = restart_position(j, N, k);
+    ends[j - first] = restart_position(j + 1, N, k);
+  }
+  for (bool walking = true; walking;) {
+    walking = false;
+    for (std::size_t j = 0; j < rows.size(); j++) {
+      if (positions[j] < ends[j]) {
+        (*ret)[positions[j]++] = source[rows[j]];
+        rows[j] = next[rows[j]];
+        walking = true;
+      }
     }
-    ret[i] = source[(suffix_array[i] - 1 + source.size()) % source.size()];
   }
-  return std::make_pair(std::move(ret), index);
+  return;
+}
+
+template <typename Index, typename T>
+auto IBWT_with_index_type(const std::vector<T>& source,
+                          std::size_t index,
+                          const std::vector<std::size_t>& restarts,
+                          std::size_t threads) {
+  auto&& next = next_rows<Index>(source);
+  std::vector<T> ret(source.size());
+  if (restarts.empty()) {
+    std::vector<std::size_t> start{next[index]};
+    walk_from_restarts(source, next, start, 0, 1, &ret);
+  } else {
+    threads = std::min(threads, restarts.size());
+    run_in_parallel(threads, [&](std::size_t t) {
+      walk_from_restarts(source, next, restarts,
+                         t * restarts.size() / threads,
+                         (t + 1) * restarts.size() / threads, &ret);
+      return;
+    });
+  }
+  return ret;
+}
+
+template <typename T>
+auto IBWT_with_restarts(const std::vector<T>& source,
+                        std::size_t index,
+                        const std::vector<std::size_t>& restarts,
+                        std::size_t threads) {
+  if (index >= source.size() || restarts.size() > source.size() ||
+      restarts.size() > std::numeric_limits<std::uint32_t>::max() ||
+      std::any_of(restarts.begin(), restarts.end(), [&](std::size_t row) {
+        return row >= source.size();
+      })) {
+    return std::vector<T>();
+  } else if (source.size() <= std::numeric_limits<size_type_t<4>>::max()) {
+    return IBWT_with_index_type<size_type_t<4>>(source, index, restarts,
+                                                threads);
+  } else {
+    return IBWT_with_index_type<size_type_t<8>>(source, index, restarts,
+                                                threads);
+  }
 }
 
+/// \publicsection
 /// \fn IBWT(const std::vector<T>& source, std::size_t index)
 /// \brief Inverse Burrows-Wheeler Transform Function
 /// \param[in] source sorted sequence
@@ -148,20 +726,7 @@ auto BWT(const std::vector<T>& source) {
 /// \return deconverted sequence as \c std::vector<T>
 template <typename T>
 auto IBWT(const std::vector<T>& source, std::size_t index) {
-  const auto N = source.size();
-  std::vector<std::size_t> buffer(N);
-  for (std::size_t i = 0; i < N; i++) {
-    buffer[i] = i;
-  }
-  std::stable_sort(buffer.begin(), buffer.end(), [=](auto&& x, auto&& y) {
-    return source[x] < source[y];
-  });
-  std::vector<T> ret{};
-  ret.reserve(N);
-  for (auto i = buffer[index]; ret.size() < source.size(); i = buffer[i]) {
-    ret.push_back(source[i]);
-  }
-  return ret;
+  return IBWT_with_restarts(source, index, std::vector<std::size_t>(), 1);
 }
 
 /// \fn IBWT(const std::pair<std::vector<T>, std::size_t>& source)
@@ -174,6 +739,23 @@ auto IBWT(const std::pair<std::vector<T>, std::size_t>& source) {
   return IBWT(source.first, source.second);
 }
 
+/// \fn IBWT(const std::pair<std::pair<std::vector<T>, std::size_t>,
+///                           std::vector<std::size_t>>& source,
+///           std::size_t threads)
+/// \brief Inverse Burrows-Wheeler Transform Function for \c SampledBWT;
+///        the walks from the restart points are interleaved on each
+///        thread and split among the threads
+/// \param[in] source result of \c SampledBWT
+/// \param[in] threads number of threads, \c 0 for one per hardware thread
+/// \return deconverted sequence as \c std::vector<T>
+template <typename T>
+auto IBWT(const std::pair<std::pair<std::vector<T>, std::size_t>,
+                          std::vector<std::size_t>>& source,
+          std::size_t threads = 1) {
+  return IBWT_with_restarts(source.first.first, source.first.second,
+                            source.second, number_of_threads(threads));
+}
+
 }  // namespace BurrowsWheelerTransform
 }  // namespace ResearchLibrary
 
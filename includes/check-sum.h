@@ -7,7 +7,16 @@
 #define INCLUDES_CHECK_SUM_H_
 
 #include <cstdint>
+#include <cstring>
 #include <vector>
+#include <thread>
+#include <algorithm>
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define RESEARCHLIB_CHECK_SUM_X86
+#endif
 
 #ifdef RESEARCHLIB_OFFLINE_TEST
 #include "./size-type.h"
@@ -21,6 +30,7 @@ namespace ResearchLibrary {
 namespace CheckSum {
 
 /// \privatesection
+template <std::uint32_t Polynomial = 0xEDB88320>
 struct CRC32Table {
   std::uint32_t array[256];
 
@@ -29,7 +39,7 @@ struct CRC32Table {
       auto c = size_type_t<4>(i);
       for (auto j = 0; j < 8; j++) {
         if ((c & 1) == 1) {
-          c = 0xEDB88320 ^ (c >> 1);
+          c = Polynomial ^ (c >> 1);
         } else {
           c >>= 1;
         }
@@ -44,20 +54,522 @@ struct CRC32Table {
   }
 };
 
+template <std::size_t N, std::uint32_t Polynomial = 0xEDB88320>
+struct CRC32SlicingTable {
+  std::uint32_t array[N][256];
+
+  constexpr CRC32SlicingTable() : array{} {
+    CRC32Table<Polynomial> table{};
+    for (std::size_t i = 0; i < 256; i++) {
+      array[0][i] = table[i];
+    }
+    for (std::size_t k = 1; k < N; k++) {
+      for (std::size_t i = 0; i < 256; i++) {
+        auto c = array[k - 1][i];
+        array[k][i] = table[c & 0xff] ^ (c >> 8);
+      }
+    }
+    return;
+  }
+
+  constexpr const std::uint32_t* operator[](std::size_t k) const {
+    return array[k];
+  }
+};
+
+// matrix over GF(2) that acts on a crc register; each column is a word.
+struct GF2Matrix {
+  std::uint32_t column[32];
+
+  constexpr std::uint32_t times(std::uint32_t vector) const {
+    std::uint32_t sum = 0;
+    for (std::size_t i = 0; vector != 0; vector >>= 1, i++) {
+      if ((vector & 1) != 0) {
+        sum ^= column[i];
+      }
+    }
+    return sum;
+  }
+
+  constexpr GF2Matrix operator*(const GF2Matrix& rhs) const {
+    GF2Matrix ret{};
+    for (std::size_t i = 0; i < 32; i++) {
+      ret.column[i] = times(rhs.column[i]);
+    }
+    return ret;
+  }
+};
+
+// operator that feeds length zero bytes to a crc register.
+constexpr GF2Matrix gf2_zeros_operator(std::uint32_t polynomial,
+                                       std::size_t length) {
+  GF2Matrix bit{}, ret{};
+  bit.column[0] = polynomial;
+  for (std::size_t i = 1; i < 32; i++) {
+    bit.column[i] = std::uint32_t(1) << (i - 1);
+  }
+  for (std::size_t i = 0; i < 32; i++) {
+    ret.column[i] = std::uint32_t(1) << i;
+  }
+  auto byte = bit * bit;
+  byte = byte * byte;
+  byte = byte * byte;
+  for (; length != 0; length >>= 1) {
+    if ((length & 1) != 0) {
+      ret = byte * ret;
+    }
+    byte = byte * byte;
+  }
+  return ret;
+}
+
+// gf2_zeros_operator(Polynomial, Length) spread over four byte tables.
+template <std::uint32_t Polynomial, std::size_t Length>
+struct CRC32ShiftTable {
+  std::uint32_t array[4][256];
+
+  constexpr CRC32ShiftTable() : array{} {
+    auto shift = gf2_zeros_operator(Polynomial, Length);
+    for (std::size_t k = 0; k < 4; k++) {
+      for (std::size_t i = 0; i < 256; i++) {
+        array[k][i] = shift.times(std::uint32_t(i) << (8 * k));
+      }
+    }
+    return;
+  }
+
+  constexpr std::uint32_t operator()(std::uint32_t c) const {
+    return array[0][c & 0xff] ^ array[1][(c >> 8) & 0xff]
+         ^ array[2][(c >> 16) & 0xff] ^ array[3][c >> 24];
+  }
+};
+
+template <std::size_t Slices, std::uint32_t Polynomial = 0xEDB88320>
+std::uint32_t crc32_update_table(std::uint32_t c,
+                                 const std::uint8_t* data,
+                                 std::size_t length) {
+  static_assert(Slices == 1 || (Slices != 0 && Slices % 4 == 0),
+                "Slices must be 1 or a multiple of 4");
+  static constexpr CRC32SlicingTable<Slices, Polynomial> table{};
+  std::size_t i = 0;
+  if (Slices != 1) {
+    // the first word of each step absorbs the current remainder,
+    // every byte is then advanced to the end of the step by its own table.
+    for (; i + Slices <= length; i += Slices) {
+      std::uint32_t next = 0;
+      for (std::size_t j = 0; j < Slices; j += 4) {
+        auto word = std::uint32_t(data[i + j])
+                  | std::uint32_t(data[i + j + 1]) << 8
+                  | std::uint32_t(data[i + j + 2]) << 16
+                  | std::uint32_t(data[i + j + 3]) << 24;
+        if (j == 0) {
+          word ^= c;
+        }
+        next ^= table[Slices - 1 - j][word & 0xff]
+              ^ table[Slices - 2 - j][(word >> 8) & 0xff]
+              ^ table[Slices - 3 - j][(word >> 16) & 0xff]
+              ^ table[Slices - 4 - j][word >> 24];
+      }
+      c = next;
+    }
+  }
+  for (; i < length; i++) {
+    c = table[0][(c ^ data[i]) & 0xff] ^ (c >> 8);
+  }
+  return c;
+}
+
+#ifdef RESEARCHLIB_CHECK_SUM_X86
+struct CPUFeatures {
+  bool sse2, sse41, sse42, pclmul, avx2;
+};
+
+template <typename = int>
+const CPUFeatures& cpu_features() {
+  static const CPUFeatures features = [] {
+    __builtin_cpu_init();
+    CPUFeatures ret{};
+    ret.sse2 = __builtin_cpu_supports("sse2");
+    ret.sse41 = __builtin_cpu_supports("sse4.1");
+    ret.sse42 = __builtin_cpu_supports("sse4.2");
+    ret.pclmul = __builtin_cpu_supports("pclmul");
+    ret.avx2 = __builtin_cpu_supports("avx2");
+    return ret;
+  }();
+  return features;
+}
+
+template <typename = int>
+__attribute__((target("pclmul,sse4.1")))
+__m128i crc32_fold(__m128i x, __m128i k, __m128i y) {
+  auto lo = _mm_clmulepi64_si128(x, k, 0x00);
+  auto hi = _mm_clmulepi64_si128(x, k, 0x11);
+  return _mm_xor_si128(_mm_xor_si128(hi, lo), y);
+}
+
+template <typename = int>
+__attribute__((target("pclmul,sse4.1")))
+__m128i crc32_load(const std::uint8_t* p) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+// folds 64 bytes per step with carry-less multiplications, then reduces
+// the 128-bit remainder by Barrett's method.
+// constants from "Fast CRC Computation for Generic Polynomials Using
+// PCLMULQDQ Instruction" (Gopal et al., Intel, 2009), bit-reflected.
+// requires length >= 64 and length % 16 == 0.
+template <typename = int>
+__attribute__((target("pclmul,sse4.1")))
+std::uint32_t crc32_update_clmul(std::uint32_t c,
+                                 const std::uint8_t* data,
+                                 std::size_t length) {
+  const auto k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+  const auto k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+  const auto k5k0 = _mm_set_epi64x(0x0000000000, 0x0163cd6124);
+  const auto poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+  const auto mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+
+  auto x1 = _mm_xor_si128(crc32_load(data),
+                          _mm_cvtsi32_si128(static_cast<int>(c)));
+  auto x2 = crc32_load(data + 16);
+  auto x3 = crc32_load(data + 32);
+  auto x4 = crc32_load(data + 48);
+  data += 64;
+  length -= 64;
+  for (; length >= 64; data += 64, length -= 64) {
+    x1 = crc32_fold(x1, k1k2, crc32_load(data));
+    x2 = crc32_fold(x2, k1k2, crc32_load(data + 16));
+    x3 = crc32_fold(x3, k1k2, crc32_load(data + 32));
+    x4 = crc32_fold(x4, k1k2, crc32_load(data + 48));
+  }
+  x1 = crc32_fold(x1, k3k4, x2);
+  x1 = crc32_fold(x1, k3k4, x3);
+  x1 = crc32_fold(x1, k3k4, x4);
+  for (; length >= 16; data += 16, length -= 16) {
+    x1 = crc32_fold(x1, k3k4, crc32_load(data));
+  }
+
+  // 128 bits to 64 bits
+  x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_and_si128(x1, mask32);
+  x1 = _mm_xor_si128(_mm_clmulepi64_si128(x1, k5k0, 0x00), x2);
+
+  // 64 bits to 32 bits
+  x2 = _mm_and_si128(x1, mask32);
+  x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+  x2 = _mm_and_si128(x2, mask32);
+  x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+  return static_cast<std::uint32_t>(_mm_extract_epi32(x1, 1));
+}
+
+#endif
+
+// picks the fastest engine available on the running cpu.
+template <typename = int>
+std::uint32_t crc32_update(std::uint32_t c,
+                           const std::uint8_t* data,
+                           std::size_t length) {
+#ifdef RESEARCHLIB_CHECK_SUM_X86
+  if (length >= 64 && cpu_features().pclmul && cpu_features().sse41) {
+    auto folded_length = length & ~std::size_t(15);
+    c = crc32_update_clmul(c, data, folded_length);
+    data += folded_length;
+    length -= folded_length;
+  }
+#endif
+  return crc32_update_table<8>(c, data, length);
+}
+
+template <std::size_t Slices>
+std::uint32_t crc32_update_engine(std::uint32_t c,
+                                  const std::uint8_t* data,
+                                  std::size_t length) {
+  if (Slices == 0) {
+    return crc32_update(c, data, length);
+  } else {
+    return crc32_update_table<Slices == 0 ? 1 : Slices>(c, data, length);
+  }
+}
+
+// CRC-32C (Castagnoli) polynomial, bit-reflected
+constexpr std::uint32_t crc32c_polynomial = 0x82F63B78;
+
+#if defined(RESEARCHLIB_CHECK_SUM_X86) && defined(__x86_64__)
+// runs three independent crc32 instruction chains over three adjacent
+// parts of Length bytes, so that their latencies overlap,
+// then merges them by shifting the earlier parts over the later ones.
+template <std::size_t Length>
+__attribute__((target("sse4.2")))
+std::uint32_t crc32c_update_sse42_interleaved(std::uint32_t c,
+                                              const std::uint8_t* data) {
+  static constexpr CRC32ShiftTable<crc32c_polynomial, Length> shift{};
+  std::uint64_t c0 = c, c1 = 0, c2 = 0;
+  for (std::size_t i = 0; i < Length; i += 8) {
+    std::uint64_t w0, w1, w2;
+    std::memcpy(&w0, data + i, 8);
+    std::memcpy(&w1, data + Length + i, 8);
+    std::memcpy(&w2, data + 2 * Length + i, 8);
+    c0 = _mm_crc32_u64(c0, w0);
+    c1 = _mm_crc32_u64(c1, w1);
+    c2 = _mm_crc32_u64(c2, w2);
+  }
+  c = shift(static_cast<std::uint32_t>(c0)) ^ static_cast<std::uint32_t>(c1);
+  return shift(c) ^ static_cast<std::uint32_t>(c2);
+}
+
+template <typename = int>
+__attribute__((target("sse4.2")))
+std::uint32_t crc32c_update_sse42(std::uint32_t c,
+                                  const std::uint8_t* data,
+                                  std::size_t length) {
+  constexpr std::size_t long_length = 8192, short_length = 256;
+  for (; length >= 3 * long_length;
+         data += 3 * long_length, length -= 3 * long_length) {
+    c = crc32c_update_sse42_interleaved<long_length>(c, data);
+  }
+  for (; length >= 3 * short_length;
+         data += 3 * short_length, length -= 3 * short_length) {
+    c = crc32c_update_sse42_interleaved<short_length>(c, data);
+  }
+  std::uint64_t c64 = c;
+  for (; length >= 8; data += 8, length -= 8) {
+    std::uint64_t word;
+    std::memcpy(&word, data, 8);
+    c64 = _mm_crc32_u64(c64, word);
+  }
+  c = static_cast<std::uint32_t>(c64);
+  for (; length > 0; data++, length--) {
+    c = _mm_crc32_u8(c, *data);
+  }
+  return c;
+}
+#endif
+
+// picks the fastest engine available on the running cpu.
+template <typename = int>
+std::uint32_t crc32c_update(std::uint32_t c,
+                            const std::uint8_t* data,
+                            std::size_t length) {
+#if defined(RESEARCHLIB_CHECK_SUM_X86) && defined(__x86_64__)
+  if (cpu_features().sse42) {
+    return crc32c_update_sse42(c, data, length);
+  }
+#endif
+  return crc32_update_table<8, crc32c_polynomial>(c, data, length);
+}
+
+// defers the modulo reduction to every nmax bytes;
+// nmax is the largest n such that 255n(n+1)/2 + (n+1)(65521-1) < 2^32.
+constexpr std::size_t adler32_nmax = 5552;
+
+template <typename = int>
+std::uint32_t adler32_update_scalar(std::uint32_t adler,
+                                    const std::uint8_t* data,
+                                    std::size_t length) {
+  auto s1 = adler & 0xffff;
+  auto s2 = (adler >> 16) & 0xffff;
+  while (length > 0) {
+    auto n = std::min(length, adler32_nmax);
+    length -= n;
+    for (; n >= 4; n -= 4, data += 4) {
+      s1 += data[0];
+      s2 += s1;
+      s1 += data[1];
+      s2 += s1;
+      s1 += data[2];
+      s2 += s1;
+      s1 += data[3];
+      s2 += s1;
+    }
+    for (; n > 0; n--, data++) {
+      s1 += *data;
+      s2 += s1;
+    }
+    s1 %= 65521;
+    s2 %= 65521;
+  }
+  return (s2 << 16) | s1;
+}
+
+#ifdef RESEARCHLIB_CHECK_SUM_X86
+template <typename = int>
+__attribute__((target("sse2")))
+std::uint32_t adler32_hsum(__m128i x) {
+  x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+  x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+  return static_cast<std::uint32_t>(_mm_cvtsi128_si32(x));
+}
+
+// for each block of k bytes following (s1, s2),
+//   s2' = s2 + k * s1 + sum_i (k - i) * data[i],
+// accumulated per lane as a weighted sum inside each vector plus
+// the sum of the preceding vectors once per vector.
+template <typename = int>
+__attribute__((target("sse2")))
+std::uint32_t adler32_update_sse2(std::uint32_t adler,
+                                  const std::uint8_t* data,
+                                  std::size_t length) {
+  constexpr std::size_t width = 16;
+  const auto zero = _mm_setzero_si128();
+  const auto weights_hi = _mm_setr_epi16(16, 15, 14, 13, 12, 11, 10, 9);
+  const auto weights_lo = _mm_setr_epi16(8, 7, 6, 5, 4, 3, 2, 1);
+  auto s1 = adler & 0xffff;
+  auto s2 = (adler >> 16) & 0xffff;
+  while (length >= width) {
+    auto n = std::min(length, adler32_nmax) / width;
+    length -= n * width;
+    s2 += s1 * std::uint32_t(n * width);
+    auto v_s1 = zero, v_s2 = zero, v_prefix = zero;
+    for (; n > 0; n--, data += width) {
+      auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+      v_prefix = _mm_add_epi32(v_prefix, v_s1);
+      v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes, zero));
+      v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(
+            _mm_unpacklo_epi8(bytes, zero), weights_hi));
+      v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(
+            _mm_unpackhi_epi8(bytes, zero), weights_lo));
+    }
+    v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_prefix, 4));
+    s1 += adler32_hsum(v_s1);
+    s2 += adler32_hsum(v_s2);
+    s1 %= 65521;
+    s2 %= 65521;
+  }
+  return adler32_update_scalar((s2 << 16) | s1, data, length);
+}
+
+template <typename = int>
+__attribute__((target("avx2")))
+std::uint32_t adler32_update_avx2(std::uint32_t adler,
+                                  const std::uint8_t* data,
+                                  std::size_t length) {
+  constexpr std::size_t width = 32;
+  const auto zero = _mm256_setzero_si256();
+  const auto ones = _mm256_set1_epi16(1);
+  const auto weights = _mm256_setr_epi8(
+      32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,
+      16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+  auto s1 = adler & 0xffff;
+  auto s2 = (adler >> 16) & 0xffff;
+  while (length >= width) {
+    auto n = std::min(length, adler32_nmax) / width;
+    length -= n * width;
+    s2 += s1 * std::uint32_t(n * width);
+    auto v_s1 = zero, v_s2 = zero, v_prefix = zero;
+    for (; n > 0; n--, data += width) {
+      auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+      v_prefix = _mm256_add_epi32(v_prefix, v_s1);
+      v_s1 = _mm256_add_epi32(v_s1, _mm256_sad_epu8(bytes, zero));
+      v_s2 = _mm256_add_epi32(v_s2, _mm256_madd_epi16(
+            _mm256_maddubs_epi16(bytes, weights), ones));
+    }
+    v_s2 = _mm256_add_epi32(v_s2, _mm256_slli_epi32(v_prefix, 5));
+    auto sum1 = _mm_add_epi32(_mm256_castsi256_si128(v_s1),
+                              _mm256_extracti128_si256(v_s1, 1));
+    auto sum2 = _mm_add_epi32(_mm256_castsi256_si128(v_s2),
+                              _mm256_extracti128_si256(v_s2, 1));
+    s1 += adler32_hsum(sum1);
+    s2 += adler32_hsum(sum2);
+    s1 %= 65521;
+    s2 %= 65521;
+  }
+  return adler32_update_scalar((s2 << 16) | s1, data, length);
+}
+#endif
+
+// picks the fastest engine available on the running cpu.
+template <typename = int>
+std::uint32_t adler32_update(std::uint32_t adler,
+                             const std::uint8_t* data,
+                             std::size_t length) {
+#ifdef RESEARCHLIB_CHECK_SUM_X86
+  if (length >= 64) {
+    if (cpu_features().avx2) {
+      return adler32_update_avx2(adler, data, length);
+    } else if (cpu_features().sse2) {
+      return adler32_update_sse2(adler, data, length);
+    }
+  }
+#endif
+  return adler32_update_scalar(adler, data, length);
+}
+
+// splits data into chunks, runs update on each chunk in its own thread and
+// merges the partial check-sums in order by combine.
+template <typename Update, typename Combine>
+std::uint32_t parallel_check_sum(std::uint32_t start,
+                                 std::uint32_t initial,
+                                 const std::uint8_t* data,
+                                 std::size_t length,
+                                 std::size_t threads,
+                                 Update update,
+                                 Combine combine) {
+  constexpr std::size_t minimum_chunk_length = std::size_t(1) << 16;
+  if (threads == 0) {
+    threads = std::max(std::size_t(std::thread::hardware_concurrency()),
+                       std::size_t(1));
+  }
+  auto chunks = std::min(threads, length / minimum_chunk_length);
+  if (chunks <= 1) {
+    return update(start, data, length);
+  }
+  auto chunk_length = length / chunks;
+  auto length_of = [=](std::size_t k) {
+    return k + 1 == chunks ? length - k * chunk_length : chunk_length;
+  };
+  std::vector<std::uint32_t> partial(chunks);
+  std::vector<std::thread> workers{};
+  for (std::size_t k = 1; k < chunks; k++) {
+    workers.emplace_back([&, k] {
+      partial[k] = update(initial, data + k * chunk_length, length_of(k));
+      return;
+    });
+  }
+  partial[0] = update(start, data, chunk_length);
+  for (std::size_t k = 0; k < workers.size(); k++) {
+    workers[k].join();
+  }
+  auto ret = partial[0];
+  for (std::size_t k = 1; k < chunks; k++) {
+    ret = combine(ret, partial[k], length_of(k));
+  }
+  return ret;
+}
+
 /// \publicsection
 /// \fn CRC32(const std::vector<std::uint8_t>& data, const T& start)
 /// \brief CRC-32 Check Sum Function
+/// \tparam Slices engine selector;
+///         \c 0 picks the fastest engine for the running cpu
+///         (carry-less multiply folding on x86 with PCLMULQDQ,
+///         slicing-by-8 otherwise),
+///         \c 1 selects the classic byte-wise loop,
+///         other multiples of \c 4 (e.g. \c 8 or \c 16) select
+///         the slicing-by-N table engine.
 /// \param[in] data sequence
 /// \param[in] start initial value of the calculation. Usually, equals to 0.
 /// \return crc-32 check-sum
-template <typename T>
+template <std::size_t Slices = 0, typename T>
 auto CRC32(const std::vector<std::uint8_t>& data, const T& start) {
-  constexpr CRC32Table table{};
   auto c = ~size_type_t<4>(start);
-  for (std::size_t i = 0; i < data.size(); i++) {
-    c = table[(c ^ data[i]) & 0xff] ^ (c >> 8);
-  }
-  return ~c;
+  c = crc32_update_engine<Slices>(c, data.data(), data.size());
+  return size_type_t<4>(~c);
+}
+
+/// \fn CRC32C(const std::vector<std::uint8_t>& data, const T& start)
+/// \brief CRC-32C (Castagnoli) Check Sum Function;
+///        uses the SSE4.2 crc32 instruction when the cpu has it.
+/// \param[in] data sequence
+/// \param[in] start initial value of the calculation. Usually, equals to 0.
+/// \return crc-32c check-sum
+template <typename T>
+auto CRC32C(const std::vector<std::uint8_t>& data, const T& start) {
+  auto c = ~size_type_t<4>(start);
+  c = crc32c_update(c, data.data(), data.size());
+  return size_type_t<4>(~c);
 }
 
 /// \fn Adler32(const std::vector<std::uint8_t>& data, const T& start)
@@ -67,15 +579,212 @@ auto CRC32(const std::vector<std::uint8_t>& data, const T& start) {
 /// \return alder-32 check-sum
 template <typename T>
 auto Adler32(const std::vector<std::uint8_t>& data, const T& start) {
-  auto s1 = size_type_t<4>(start) & 0xffff;
-  auto s2 = (size_type_t<4>(start) >> 16) & 0xffff;
-  for (std::size_t i = 0; i < data.size(); i++) {
-    s1 = (s1 + data[i]) % 65521;
-    s2 = (s2 + s1) % 65521;
+  return adler32_update(size_type_t<4>(start), data.data(), data.size());
+}
+
+/// \fn CRC32Combine(std::uint32_t crc1, std::uint32_t crc2,
+///                   std::size_t length2)
+/// \brief combines the CRC-32 of two consecutive sequences
+/// \param[in] crc1 crc-32 check-sum of the first sequence
+/// \param[in] crc2 crc-32 check-sum of the second sequence, started from 0
+/// \param[in] length2 length of the second sequence
+/// \return crc-32 check-sum of the concatenated sequence
+template <typename = int>
+std::uint32_t CRC32Combine(std::uint32_t crc1,
+                           std::uint32_t crc2,
+                           std::size_t length2) {
+  if (length2 == 0) {
+    return crc1;
   }
-  return (s2 << 16) + s1;
+  return gf2_zeros_operator(0xEDB88320, length2).times(crc1) ^ crc2;
 }
 
+/// \fn Adler32Combine(std::uint32_t adler1, std::uint32_t adler2,
+///                     std::size_t length2)
+/// \brief combines the Adler-32 of two consecutive sequences
+/// \param[in] adler1 adler-32 check-sum of the first sequence
+/// \param[in] adler2 adler-32 check-sum of the second sequence, started from 1
+/// \param[in] length2 length of the second sequence
+/// \return adler-32 check-sum of the concatenated sequence
+template <typename = int>
+std::uint32_t Adler32Combine(std::uint32_t adler1,
+                             std::uint32_t adler2,
+                             std::size_t length2) {
+  constexpr std::uint32_t base = 65521;
+  auto remainder = std::uint32_t(length2 % base);
+  auto s1 = adler1 & 0xffff;
+  auto s2 = std::uint32_t(std::uint64_t(remainder) * s1 % base);
+  s1 += (adler2 & 0xffff) + base - 1;
+  s2 += ((adler1 >> 16) & 0xffff) + ((adler2 >> 16) & 0xffff)
+      + base - remainder;
+  if (s1 >= base) {
+    s1 -= base;
+  }
+  if (s1 >= base) {
+    s1 -= base;
+  }
+  if (s2 >= base * 2) {
+    s2 -= base * 2;
+  }
+  if (s2 >= base) {
+    s2 -= base;
+  }
+  return (s2 << 16) | s1;
+}
+
+/// \fn ParallelCRC32(const std::vector<std::uint8_t>& data, const T& start,
+///                    std::size_t threads)
+/// \brief CRC-32 Check Sum Function; splits the sequence into chunks,
+///        checksums them on separate threads and combines the results
+/// \tparam Slices engine selector, same as \c CRC32
+/// \param[in] data sequence
+/// \param[in] start initial value of the calculation. Usually, equals to 0.
+/// \param[in] threads number of threads; \c 0 means hardware concurrency
+/// \return crc-32 check-sum, equals to \c CRC32(data, start)
+template <std::size_t Slices = 0, typename T>
+auto ParallelCRC32(const std::vector<std::uint8_t>& data,
+                   const T& start,
+                   std::size_t threads = 0) {
+  return parallel_check_sum(size_type_t<4>(start), 0,
+                            data.data(), data.size(), threads,
+                            [](std::uint32_t c,
+                               const std::uint8_t* chunk,
+                               std::size_t length) {
+    return ~crc32_update_engine<Slices>(~c, chunk, length);
+  }, CRC32Combine<>);
+}
+
+/// \fn ParallelAdler32(const std::vector<std::uint8_t>& data,
+///                      const T& start, std::size_t threads)
+/// \brief Adler-32 Check Sum Function; splits the sequence into chunks,
+///        checksums them on separate threads and combines the results
+/// \param[in] data sequence
+/// \param[in] start initial value of the calculation. Usually, equals to 1.
+/// \param[in] threads number of threads; \c 0 means hardware concurrency
+/// \return adler-32 check-sum, equals to \c Adler32(data, start)
+template <typename T>
+auto ParallelAdler32(const std::vector<std::uint8_t>& data,
+                     const T& start,
+                     std::size_t threads = 0) {
+  return parallel_check_sum(size_type_t<4>(start), 1,
+                            data.data(), data.size(), threads,
+                            adler32_update<>, Adler32Combine<>);
+}
+
+/// \class CRC32Hasher
+/// \brief incremental CRC-32 calculator;
+///        feed the sequence piece by piece and take the check-sum at the end.
+/// \tparam Slices engine selector, same as \c CRC32
+template <std::size_t Slices = 0>
+class CRC32Hasher {
+ private:
+  std::uint32_t state;
+
+ public:
+  /// \fn CRC32Hasher(std::uint32_t start)
+  /// \brief Constructor of class CRC32Hasher
+  /// \param[in] start initial value of the calculation. Usually, equals to 0.
+  explicit CRC32Hasher(std::uint32_t start = 0) : state(~start) {
+    return;
+  }
+
+  /// \fn update(const std::uint8_t* data, std::size_t length)
+  /// \brief feed a piece of the sequence
+  /// \param[in] data pointer to the piece
+  /// \param[in] length length of the piece
+  CRC32Hasher& update(const std::uint8_t* data, std::size_t length) {
+    state = crc32_update_engine<Slices>(state, data, length);
+    return *this;
+  }
+
+  /// \fn update(const std::vector<std::uint8_t>& data)
+  /// \brief feed a piece of the sequence
+  /// \param[in] data the piece
+  CRC32Hasher& update(const std::vector<std::uint8_t>& data) {
+    return update(data.data(), data.size());
+  }
+
+  /// \fn update(Iterator first, Iterator last)
+  /// \brief feed a piece of the sequence given by input iterators
+  /// \param[in] first begin of the piece
+  /// \param[in] last end of the piece
+  template <typename Iterator>
+  CRC32Hasher& update(Iterator first, Iterator last) {
+    std::uint8_t buffer[256];
+    while (first != last) {
+      std::size_t length = 0;
+      for (; length < sizeof(buffer) && first != last; ++first, length++) {
+        buffer[length] = static_cast<std::uint8_t>(*first);
+      }
+      update(buffer, length);
+    }
+    return *this;
+  }
+
+  /// \fn finish()
+  /// \brief get the check-sum of the sequence fed so far
+  /// \return crc-32 check-sum
+  std::uint32_t finish() const {
+    return ~state;
+  }
+};
+
+/// \class Adler32Hasher
+/// \brief incremental Adler-32 calculator;
+///        feed the sequence piece by piece and take the check-sum at the end.
+class Adler32Hasher {
+ private:
+  std::uint32_t state;
+
+ public:
+  /// \fn Adler32Hasher(std::uint32_t start)
+  /// \brief Constructor of class Adler32Hasher
+  /// \param[in] start initial value of the calculation. Usually, equals to 1.
+  explicit Adler32Hasher(std::uint32_t start = 1) : state(start) {
+    return;
+  }
+
+  /// \fn update(const std::uint8_t* data, std::size_t length)
+  /// \brief feed a piece of the sequence
+  /// \param[in] data pointer to the piece
+  /// \param[in] length length of the piece
+  Adler32Hasher& update(const std::uint8_t* data, std::size_t length) {
+    state = adler32_update(state, data, length);
+    return *this;
+  }
+
+  /// \fn update(const std::vector<std::uint8_t>& data)
+  /// \brief feed a piece of the sequence
+  /// \param[in] data the piece
+  Adler32Hasher& update(const std::vector<std::uint8_t>& data) {
+    return update(data.data(), data.size());
+  }
+
+  /// \fn update(Iterator first, Iterator last)
+  /// \brief feed a piece of the sequence given by input iterators
+  /// \param[in] first begin of the piece
+  /// \param[in] last end of the piece
+  template <typename Iterator>
+  Adler32Hasher& update(Iterator first, Iterator last) {
+    std::uint8_t buffer[256];
+    while (first != last) {
+      std::size_t length = 0;
+      for (; length < sizeof(buffer) && first != last; ++first, length++) {
+        buffer[length] = static_cast<std::uint8_t>(*first);
+      }
+      update(buffer, length);
+    }
+    return *this;
+  }
+
+  /// \fn finish()
+  /// \brief get the check-sum of the sequence fed so far
+  /// \return adler-32 check-sum
+  std::uint32_t finish() const {
+    return state;
+  }
+};
+
 }  // namespace CheckSum
 }  // namespace ResearchLibrary
 
@@ -337,7 +337,9 @@ Encode_l1:
 /// \return inflated sequence as \c std::vector<std::uint8_t>
 template <typename = int>
 auto Decode(const std::vector<std::uint8_t>& source) {
-  BytesToBits<8> buffer(source);
+  using HuffmanCoding::make_decode_table;
+  using HuffmanCoding::decode_symbol;
+  BytesToBits<8> buffer(source.data(), source.size());
   bool is_final = false;
   std::vector<std::uint8_t> ret{};
   constexpr std::array<std::size_t, 19> pack
@@ -358,7 +360,7 @@ auto Decode(const std::vector<std::uint8_t>& source) {
     = {{   1,    2,    3,    4,    5,    7,    9,    13,    17,    25,
           33,   49,   65,   97,  129,  193,  257,   385,   513,   769,
         1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577}};
-  while (!is_final) {
+  while (!is_final && !buffer.overrun()) {
     is_final = buffer.get(1);
     auto type = buffer.get(2);
     std::map<unsigned_integer_t, std::size_t> literal_length_map{};
@@ -401,24 +403,15 @@ auto Decode(const std::vector<std::uint8_t>& source) {
           length_length_map[pack[i]] = length;
         }
       }
-      auto length_code_map = HuffmanCoding
-                           ::length_map_to_code_map(length_length_map);
+      auto length_table = make_decode_table<BitOrder::LSBFirst>(
+          HuffmanCoding::length_map_to_code_map(length_length_map));
       std::vector<std::size_t> length_map{};
       for (; length_map.size() < hlit + hdist + 258;) {
-        unsigned_integer_t huffman_code = 0, code = 0;
-        std::size_t length = 0;
-        for (std::size_t j = 1; length == 0; j++) {
-          huffman_code = buffer.rget(1, huffman_code);
-          for (auto it = length_code_map.begin();
-                    it != length_code_map.end();
-                    ++it) {
-            if (it->second.first == j && it->second.second == huffman_code) {
-              length = j;
-              code = it->first;
-              break;
-            }
-          }
+        auto&& entry = decode_symbol(&buffer, length_table);
+        if (entry.length == 0) {
+          return ret;
         }
+        auto code = entry.value;
         if (code < 16) {
           length_map.push_back(code);
         } else if (code == 16) {
@@ -455,49 +448,41 @@ auto Decode(const std::vector<std::uint8_t>& source) {
     } else {
       return ret;
     }
-    auto literal_code_map = HuffmanCoding
-                          ::length_map_to_code_map(literal_length_map);
-    auto distance_code_map = HuffmanCoding
-                           ::length_map_to_code_map(distance_length_map);
-    for (;;) {
-      unsigned_integer_t huffman_code = 0, value = 0;
+    auto literal_table = make_decode_table<BitOrder::LSBFirst>(
+        HuffmanCoding::length_map_to_code_map(literal_length_map));
+    auto distance_table = make_decode_table<BitOrder::LSBFirst>(
+        HuffmanCoding::length_map_to_code_map(distance_length_map));
+    while (!buffer.overrun()) {
+      auto&& literal = decode_symbol(&buffer, literal_table);
+      auto value = literal.value;
       std::size_t length = 0, distance = 0;
-      for (std::size_t j = 1; length == 0; j++) {
-        huffman_code = buffer.rget(1, huffman_code);
-        for (auto it = literal_code_map.begin();
-                  it != literal_code_map.end();
-                  ++it) {
-          if (it->second.first == j && it->second.second == huffman_code) {
-            length = j;
-            value = it->first;
-            break;
-          }
-        }
-      }
-      if (value < 256) {
+      if (literal.length == 0) {
+        return ret;
+      } else if (value < 256) {
         ret.push_back(static_cast<std::uint8_t>(value));
       } else if (value == 256) {
         break;
       } else {
         value -= 257;
+        if (value >= literal_extra_base.size()) {
+          return ret;
+        }
         length = literal_extra_base[value]
                + buffer.get(literal_extra_bits[value]);
-        huffman_code = 0;
-        std::size_t code_length = 0;
-        for (std::size_t j = 1; code_length == 0; j++) {
-          huffman_code = buffer.rget(1, huffman_code);
-          for (auto it = distance_code_map.begin();
-                    it != distance_code_map.end();
-                    ++it) {
-            if (it->second.first == j && it->second.second == huffman_code) {
-              code_length = j;
-              value = it->first;
-              break;
-            }
-          }
+        auto&& distance_code = decode_symbol(&buffer, distance_table);
+        if (distance_code.length == 0) {
+          return ret;
+        }
+        value = distance_code.value;
+        if (value >= distance_extra_base.size()) {
+          return ret;
         }
         distance = distance_extra_base[value]
                  + buffer.get(distance_extra_bits[value]);
+        // a corrupt stream may point before the start of the output
+        if (distance == 0 || distance > ret.size()) {
+          return ret;
+        }
         auto start = ret.size() - distance;
         for (std::size_t i = 0; i < length; i++) {
           ret.push_back(ret[start + i]);
@@ -0,0 +1,669 @@
+// Copyright 2015 pixie.grasper
+/// \file external-burrows-wheeler-transform.h
+/// \brief Implementation of the Burrows-Wheeler Transform for files larger
+///        than the memory
+/// \author pixie.grasper
+
+#ifndef INCLUDES_EXTERNAL_BURROWS_WHEELER_TRANSFORM_H_
+#define INCLUDES_EXTERNAL_BURROWS_WHEELER_TRANSFORM_H_
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+/// \privatesection
+int gets();
+/// \publicsection
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <queue>
+#include <memory>
+#include <utility>
+#include <algorithm>
+
+#ifdef RESEARCHLIB_OFFLINE_TEST
+#include "./size-type.h"
+#include "./burrows-wheeler-transform.h"
+#include "./file-vector-converter.h"
+#else
+#include <size-type.h>
+#include <burrows-wheeler-transform.h>
+#include <file-vector-converter.h>
+#endif
+
+/// \namespace ResearchLibrary
+/// \namespace ResearchLibrary::BurrowsWheelerTransform
+namespace ResearchLibrary {
+namespace BurrowsWheelerTransform {
+
+/// \privatesection
+template <typename = int>
+void store_u64(std::uint8_t* p, std::uint64_t value) {
+  std::memcpy(p, &value, sizeof(value));
+  return;
+}
+
+template <typename = int>
+std::uint64_t load_u64(const std::uint8_t* p) {
+  std::uint64_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+// rotation starting at position, by the ranks of its first and second
+// halves, and the symbol before it.  the records go to the disk field by
+// field, without the padding of the struct.
+struct RotationPair {
+  std::uint64_t first, second, position;
+  std::uint8_t previous;
+
+  static constexpr std::size_t encoded_length() {
+    return 25;
+  }
+
+  void store(std::uint8_t* p) const {
+    store_u64(p, first);
+    store_u64(p + 8, second);
+    store_u64(p + 16, position);
+    p[24] = previous;
+    return;
+  }
+
+  void load(const std::uint8_t* p) {
+    first = load_u64(p);
+    second = load_u64(p + 8);
+    position = load_u64(p + 16);
+    previous = p[24];
+    return;
+  }
+};
+
+// rank of the rotation starting at position, the symbol before it, and
+// whether the rank is final.  a rank is a row, so done takes the top bit
+// of it on the disk.
+struct RotationRank {
+  std::uint64_t position, rank;
+  std::uint8_t previous, done;
+
+  static constexpr std::size_t encoded_length() {
+    return 17;
+  }
+
+  void store(std::uint8_t* p) const {
+    store_u64(p, position);
+    store_u64(p + 8, rank | std::uint64_t(done != 0) << 63);
+    p[16] = previous;
+    return;
+  }
+
+  void load(const std::uint8_t* p) {
+    position = load_u64(p);
+    rank = load_u64(p + 8);
+    done = std::uint8_t(rank >> 63);
+    rank &= ~(std::uint64_t(1) << 63);
+    previous = p[16];
+    return;
+  }
+};
+
+template <typename = int>
+bool pair_less(const RotationPair& lhs, const RotationPair& rhs) {
+  if (lhs.first != rhs.first) {
+    return lhs.first < rhs.first;
+  } else if (lhs.second != rhs.second) {
+    return lhs.second < rhs.second;
+  }
+  return lhs.position < rhs.position;
+}
+
+template <typename = int>
+bool position_less(const RotationRank& lhs, const RotationRank& rhs) {
+  return lhs.position < rhs.position;
+}
+
+template <typename = int>
+bool rank_less(const RotationRank& lhs, const RotationRank& rhs) {
+  return lhs.rank < rhs.rank;
+}
+
+// reads the records of a file in order from the first-th one, going round
+// to the start after the last one.  a file that cannot be opened or read
+// is not good, rather than empty.
+template <typename Record>
+class RecordReader {
+ private:
+  int fd;
+  std::size_t count, first;
+  std::vector<std::uint8_t> buffer;
+  std::size_t buffered, used, file_index;
+  bool failed;
+
+  bool fill() {
+    if (file_index == count) {
+      if (lseek(fd, 0, SEEK_SET) == -1) {
+        failed = true;
+        return false;
+      }
+      file_index = 0;
+    }
+    auto n = std::min(buffer.size() / Record::encoded_length(),
+                      count - file_index);
+    auto length = read_fully(fd, buffer.data(), n * Record::encoded_length());
+    buffered = length / Record::encoded_length();
+    used = 0;
+    file_index += buffered;
+    failed = failed || buffered != n;
+    return buffered != 0;
+  }
+
+ public:
+  RecordReader(const char* name, std::size_t buffer_bytes,
+               std::size_t first_ = 0)
+      : fd(open(name, O_RDONLY)), count(0), first(0),
+        buffer(std::max(buffer_bytes / Record::encoded_length(),
+                        std::size_t(1)) * Record::encoded_length()),
+        buffered(0), used(0), file_index(0), failed(true) {
+    struct stat s;
+    if (fd == -1 || fstat(fd, &s) == -1 ||
+        std::size_t(s.st_size) % Record::encoded_length() != 0) {
+      return;
+    }
+    count = std::size_t(s.st_size) / Record::encoded_length();
+    first = count == 0 ? 0 : first_ % count;
+    file_index = first;
+    if (lseek(fd, off_t(first * Record::encoded_length()), SEEK_SET) == -1) {
+      count = 0;
+      return;
+    }
+    failed = false;
+    return;
+  }
+
+  RecordReader(const RecordReader&) = delete;
+  RecordReader& operator=(const RecordReader&) = delete;
+
+  ~RecordReader() {
+    if (fd != -1) {
+      close(fd);
+    }
+    return;
+  }
+
+  std::size_t size() const {
+    return count;
+  }
+
+  // false if the file could not be opened, or a read failed
+  bool good() const {
+    return !failed;
+  }
+
+  // the next record; false after an error.  the records go round, so the
+  // caller counts them.
+  bool get(Record* record) {
+    if (failed || count == 0 || (used == buffered && !fill())) {
+      return false;
+    }
+    record->load(&buffer[used * Record::encoded_length()]);
+    used++;
+    return true;
+  }
+};
+
+// removes the files named so far when it goes out of scope, whether the
+// work succeeded or not.
+class TemporaryFiles {
+ private:
+  std::vector<std::string> names;
+
+ public:
+  TemporaryFiles() : names{} {
+    return;
+  }
+
+  TemporaryFiles(const TemporaryFiles&) = delete;
+  TemporaryFiles& operator=(const TemporaryFiles&) = delete;
+
+  ~TemporaryFiles() {
+    for (auto&& name : names) {
+      unlink(name.c_str());
+    }
+    return;
+  }
+
+  const std::string& add(const std::string& name) {
+    names.push_back(name);
+    return names.back();
+  }
+};
+
+template <typename Record>
+void put_record(FileWriter* writer, const Record& record) {
+  std::uint8_t bytes[Record::encoded_length()];
+  record.store(bytes);
+  writer->write(bytes, Record::encoded_length());
+  return;
+}
+
+// merges the sorted runs into output and removes them.
+template <typename Record, typename Less>
+bool merge_runs(const std::vector<std::string>& runs,
+                const std::string& output,
+                std::size_t buffer_bytes,
+                Less less) {
+  std::vector<std::unique_ptr<RecordReader<Record>>> readers{};
+  std::vector<std::size_t> remaining{};
+  using Head = std::pair<Record, std::size_t>;
+  auto greater = [&](const Head& lhs, const Head& rhs) {
+    return less(rhs.first, lhs.first);
+  };
+  std::priority_queue<Head, std::vector<Head>, decltype(greater)>
+      heads(greater);
+  auto good = true;
+  for (std::size_t k = 0; good && k < runs.size(); k++) {
+    readers.emplace_back(new RecordReader<Record>(runs[k].c_str(),
+                                                  buffer_bytes));
+    remaining.push_back(readers[k]->size());
+    Record record;
+    good = readers[k]->good();
+    if (good && remaining[k] != 0) {
+      good = readers[k]->get(&record);
+      if (good) {
+        heads.emplace(record, k);
+        remaining[k]--;
+      }
+    }
+  }
+  FileWriter writer(output.c_str(), buffer_bytes);
+  while (good && !heads.empty()) {
+    auto head = heads.top();
+    heads.pop();
+    put_record(&writer, head.first);
+    auto k = head.second;
+    if (remaining[k] != 0) {
+      good = readers[k]->get(&head.first);
+      if (good) {
+        heads.push(head);
+        remaining[k]--;
+      }
+    }
+  }
+  writer.flush();
+  readers.clear();
+  for (auto&& run : runs) {
+    unlink(run.c_str());
+  }
+  return good && writer.good();
+}
+
+// sorts the records of input into output through sorted runs of about
+// memory_budget bytes, merged as many at a time as the budget allows.
+// the runs are removed on every path out, and input once it is split.
+template <typename Record, typename Less>
+bool external_sort(const std::string& input,
+                   const std::string& output,
+                   std::size_t memory_budget,
+                   Less less) {
+  const auto buffer_bytes = std::max(std::min(memory_budget / 8,
+                                              std::size_t(1) << 20),
+                                     std::size_t(1) << 12);
+  const auto run_records = std::max(
+      (memory_budget - std::min(memory_budget, buffer_bytes * 2)) /
+      sizeof(Record), std::size_t(1));
+  const auto fan_in = std::max(memory_budget / buffer_bytes - 1,
+                               std::size_t(2));
+  std::vector<std::string> runs{};
+  TemporaryFiles temporaries{};
+  std::size_t names = 0;
+  auto next_name = [&]() {
+    return temporaries.add(output + ".run" + std::to_string(names++));
+  };
+  {
+    RecordReader<Record> reader(input.c_str(), buffer_bytes);
+    if (!reader.good()) {
+      return false;
+    }
+    std::vector<Record> chunk{};
+    chunk.reserve(std::min(run_records, reader.size()));
+    for (std::size_t i = 0; i < reader.size();) {
+      chunk.clear();
+      for (; i < reader.size() && chunk.size() < run_records; i++) {
+        Record record;
+        if (!reader.get(&record)) {
+          return false;
+        }
+        chunk.push_back(record);
+      }
+      std::sort(chunk.begin(), chunk.end(), less);
+      runs.push_back(next_name());
+      FileWriter writer(runs.back().c_str(), buffer_bytes);
+      for (auto&& record : chunk) {
+        put_record(&writer, record);
+      }
+      writer.flush();
+      if (!writer.good()) {
+        return false;
+      }
+    }
+  }
+  unlink(input.c_str());
+  while (runs.size() > fan_in) {
+    std::vector<std::string> merged{};
+    for (std::size_t k = 0; k < runs.size(); k += fan_in) {
+      std::vector<std::string> group(
+          runs.begin() + std::ptrdiff_t(k),
+          runs.begin() + std::ptrdiff_t(std::min(k + fan_in, runs.size())));
+      merged.push_back(next_name());
+      if (!merge_runs<Record>(group, merged.back(), buffer_bytes, less)) {
+        return false;
+      }
+    }
+    runs = std::move(merged);
+  }
+  if (runs.size() == 1) {
+    return std::rename(runs[0].c_str(), output.c_str()) == 0;
+  }
+  return merge_runs<Record>(runs, output, buffer_bytes, less);
+}
+
+template <typename = int>
+bool file_size(const char* name, std::size_t* size) {
+  struct stat s;
+  if (stat(name, &s) == -1) {
+    return false;
+  }
+  *size = std::size_t(s.st_size);
+  return true;
+}
+
+// the pairs of every rotation by its first 8 symbols, all in one group;
+// the rotations near the end take their tail from the head of the file.
+template <typename = int>
+bool initial_pairs(const char* input_name,
+                   std::size_t N,
+                   const std::string& output,
+                   std::size_t buffer_bytes) {
+  FileReader reader(input_name, buffer_bytes);
+  FileWriter writer(output.c_str(), buffer_bytes);
+  std::vector<std::uint8_t> head{};
+  std::uint64_t window = 0;
+  std::uint8_t dropped = 0;
+  std::size_t j = 0;
+  RotationPair first_pair{};
+  auto shift_in = [&](std::uint8_t c) {
+    dropped = std::uint8_t(window >> 56);
+    window = window << 8 | c;
+    if (j >= 7) {
+      RotationPair pair{};
+      pair.second = window;
+      pair.position = j - 7;
+      pair.previous = dropped;
+      if (pair.position == 0) {
+        first_pair = pair;
+      } else {
+        put_record(&writer, pair);
+      }
+    }
+    j++;
+    return;
+  };
+  while (!reader.eof()) {
+    auto&& block = reader.next();
+    for (auto&& c : block) {
+      if (head.size() < 7) {
+        head.push_back(c);
+      }
+      shift_in(c);
+    }
+  }
+  if (j != N) {
+    return false;
+  }
+  for (auto&& c : head) {
+    shift_in(c);
+  }
+  // the symbol before the first rotation is the last one of the file
+  first_pair.previous = std::uint8_t(window >> 56);
+  put_record(&writer, first_pair);
+  writer.flush();
+  return writer.good();
+}
+
+// splits the groups of the sorted pairs by their second ranks; the rank of
+// a rotation is the first row of its group, so that of a new group is the
+// old rank plus the rows before it in the old group.  a rotation alone in
+// its group is done.  once the pairs cover the whole rotations, equal ones
+// take the rows in the order of their positions.  returns the number of
+// the rotations not done yet.
+template <typename = int>
+std::size_t refine_ranks(const std::string& sorted,
+                         const std::string& updates,
+                         bool whole,
+                         std::size_t buffer_bytes,
+                         bool* good) {
+  RecordReader<RotationPair> reader(sorted.c_str(), buffer_bytes);
+  FileWriter writer(updates.c_str(), buffer_bytes);
+  RotationPair last{};
+  RotationRank pending{};
+  std::uint64_t offset = 0, rank = 0;
+  auto pending_starts = false;
+  std::size_t not_done = 0;
+  auto emit = [&](bool done) {
+    pending.done = std::uint8_t(whole || done);
+    not_done += pending.done ? 0 : 1;
+    put_record(&writer, pending);
+    return;
+  };
+  *good = reader.good();
+  for (std::size_t row = 0; *good && row < reader.size(); row++) {
+    RotationPair pair;
+    if (!reader.get(&pair)) {
+      *good = false;
+      break;
+    }
+    auto new_group = row == 0 || pair.first != last.first;
+    offset = new_group ? 0 : offset + 1;
+    auto new_subgroup = new_group || pair.second != last.second;
+    if (new_subgroup) {
+      rank = pair.first + offset;
+    }
+    if (row != 0) {
+      emit(pending_starts && new_subgroup);
+    }
+    pending.position = pair.position;
+    pending.rank = whole ? pair.first + offset : rank;
+    pending.previous = pair.previous;
+    pending_starts = new_subgroup;
+    last = pair;
+  }
+  if (*good && reader.size() != 0) {
+    emit(pending_starts);
+  }
+  writer.flush();
+  *good = *good && writer.good();
+  unlink(sorted.c_str());
+  return not_done;
+}
+
+// the pairs of the rotations not done, by their ranks and the ranks of the
+// rotations h ahead, joining the ranks with themselves.
+template <typename = int>
+bool doubled_pairs(const std::string& ranks,
+                   std::size_t N,
+                   std::size_t h,
+                   const std::string& output,
+                   std::size_t buffer_bytes) {
+  RecordReader<RotationRank> at(ranks.c_str(), buffer_bytes);
+  RecordReader<RotationRank> ahead(ranks.c_str(), buffer_bytes, h);
+  FileWriter writer(output.c_str(), buffer_bytes);
+  if (!at.good() || !ahead.good() || at.size() != N) {
+    return false;
+  }
+  for (std::size_t i = 0; i < N; i++) {
+    RotationRank lhs, rhs;
+    if (!at.get(&lhs) || !ahead.get(&rhs)) {
+      return false;
+    }
+    if (!lhs.done) {
+      RotationPair pair{};
+      pair.first = lhs.rank;
+      pair.second = rhs.rank;
+      pair.position = lhs.position;
+      pair.previous = lhs.previous;
+      put_record(&writer, pair);
+    }
+  }
+  writer.flush();
+  return writer.good();
+}
+
+// replaces the ranks by the updates, both in the order of the positions.
+template <typename = int>
+bool update_ranks(const std::string& ranks,
+                  const std::string& updates,
+                  const std::string& output,
+                  std::size_t buffer_bytes) {
+  {
+    RecordReader<RotationRank> old_ranks(ranks.c_str(), buffer_bytes);
+    RecordReader<RotationRank> new_ranks(updates.c_str(), buffer_bytes);
+    FileWriter writer(output.c_str(), buffer_bytes);
+    if (!old_ranks.good() || !new_ranks.good()) {
+      return false;
+    }
+    RotationRank update{};
+    std::size_t used = 0;
+    auto has_update = used < new_ranks.size() && new_ranks.get(&update);
+    for (std::size_t i = 0; i < old_ranks.size(); i++) {
+      RotationRank rank;
+      if (!old_ranks.get(&rank)) {
+        return false;
+      }
+      if (has_update && update.position == rank.position) {
+        put_record(&writer, update);
+        used++;
+        has_update = used < new_ranks.size() && new_ranks.get(&update);
+      } else {
+        put_record(&writer, rank);
+      }
+    }
+    writer.flush();
+    if (used != new_ranks.size() || !writer.good()) {
+      return false;
+    }
+  }
+  unlink(updates.c_str());
+  return std::rename(output.c_str(), ranks.c_str()) == 0;
+}
+
+// writes the symbols before the N rotations in the order of their ranks.
+template <typename = int>
+bool write_sorted_symbols(const std::string& sorted,
+                          std::size_t N,
+                          const char* output_name,
+                          std::size_t buffer_bytes,
+                          std::size_t* index) {
+  RecordReader<RotationRank> reader(sorted.c_str(), buffer_bytes);
+  if (!reader.good() || reader.size() != N) {
+    return false;
+  }
+  FileWriter writer(output_name, buffer_bytes);
+  for (std::size_t row = 0; row < reader.size(); row++) {
+    RotationRank rank;
+    if (!reader.get(&rank)) {
+      return false;
+    }
+    writer.write(&rank.previous, 1);
+    if (rank.position == 0) {
+      *index = row;
+    }
+  }
+  writer.flush();
+  return writer.good();
+}
+
+/// \publicsection
+/// \fn ExternalBWT(const char* input_name, const char* output_name,
+///                 std::size_t memory_budget)
+/// \brief Burrows-Wheeler Transform Function for a file that does not fit
+///        in the memory; the result equals that of \c BWT of the bytes of
+///        the file.  the rotations are sorted by prefix doubling with
+///        discarding: every round sorts a record per rotation whose rank
+///        is not final yet on the disk, by merging sorted runs of about
+///        \c memory_budget bytes, and the other rotations only take part
+///        in sequential scans.  the temporary files are made next to the
+///        output and named after it, and take up to about 60 bytes of the
+///        disk per byte of the input.  a file that fits in the budget is
+///        transformed in the memory.
+/// \param[in] input_name name of the file to transform
+/// \param[in] output_name name of the file to write the sorted sequence
+/// \param[in] memory_budget bytes of memory to use, roughly;
+///            at least 64 KiB
+/// \return \c std::pair of index as \c std::size_t and whether the
+///         transform succeeded as \c bool
+template <typename = int>
+auto ExternalBWT(const char* input_name,
+                 const char* output_name,
+                 std::size_t memory_budget = std::size_t(1) << 28) {
+  // enough for a few hundred records per run besides the buffers
+  memory_budget = std::max(memory_budget, std::size_t(1) << 16);
+  std::size_t N = 0;
+  if (!file_size(input_name, &N)) {
+    return std::make_pair(std::size_t(0), false);
+  }
+  // SA-IS over the doubled sequence takes about 24 bytes per symbol
+  if (N < 8 || N <= memory_budget / 24) {
+    auto&& bwt = BWT<SuffixSorter::InducedSorting>(File::load(input_name));
+    if (bwt.first.size() != N) {
+      return std::make_pair(std::size_t(0), false);
+    }
+    FileWriter writer(output_name);
+    writer.write(bwt.first);
+    writer.flush();
+    return std::make_pair(bwt.second, writer.good());
+  }
+  const auto buffer_bytes = std::max(std::min(memory_budget / 8,
+                                              std::size_t(1) << 20),
+                                     std::size_t(1) << 12);
+  const std::string base = std::string(output_name) + ".tmp";
+  TemporaryFiles temporaries{};
+  const auto pairs = temporaries.add(base + ".pairs"),
+             sorted = temporaries.add(base + ".sorted"),
+             updates = temporaries.add(base + ".updates"),
+             ranks = temporaries.add(base + ".ranks"),
+             merged = temporaries.add(base + ".merged");
+  // ranks of the rotations by their first 8 symbols
+  auto good = initial_pairs(input_name, N, pairs, buffer_bytes) &&
+              external_sort<RotationPair>(pairs, sorted, memory_budget,
+                                          pair_less<>);
+  auto not_done = good ? refine_ranks(sorted, updates, N <= 8,
+                                      buffer_bytes, &good) : 0;
+  good = good && external_sort<RotationRank>(updates, ranks, memory_budget,
+                                             position_less<>);
+  // ranks by the first 2h symbols from those by the first h symbols
+  for (std::size_t h = 8; good && not_done != 0; h *= 2) {
+    good = doubled_pairs(ranks, N, h, pairs, buffer_bytes) &&
+           external_sort<RotationPair>(pairs, sorted, memory_budget,
+                                       pair_less<>);
+    not_done = good ? refine_ranks(sorted, updates, h * 2 >= N,
+                                   buffer_bytes, &good) : 0;
+    good = good &&
+           external_sort<RotationRank>(updates, sorted, memory_budget,
+                                       position_less<>) &&
+           update_ranks(ranks, sorted, merged, buffer_bytes);
+  }
+  std::size_t index = 0;
+  good = good &&
+         external_sort<RotationRank>(ranks, sorted, memory_budget,
+                                     rank_less<>) &&
+         write_sorted_symbols(sorted, N, output_name, buffer_bytes,
+                              &index);
+  return std::make_pair(index, good);
+}
+
+}  // namespace BurrowsWheelerTransform
+}  // namespace ResearchLibrary
+
+#endif  // INCLUDES_EXTERNAL_BURROWS_WHEELER_TRANSFORM_H_
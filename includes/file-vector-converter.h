@@ -7,14 +7,24 @@
 #define INCLUDES_FILE_VECTOR_CONVERTER_H_
 
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <errno.h>
+#include <limits.h>
 
 /// \privatesection
 int gets();
 /// \publicsection
 #include <cstdint>
 #include <vector>
+#include <deque>
+#include <utility>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #ifdef RESEARCHLIB_OFFLINE_TEST
 #include "./size-type.h"
@@ -25,6 +35,259 @@ int gets();
 /// \namespace ResearchLibrary
 namespace ResearchLibrary {
 
+/// \privatesection
+// read(2) until length bytes arrive, the end of the file, or an error;
+// returns the number of bytes read, and sets *failed on an error.
+template <typename = int>
+std::size_t read_fully(int fd, std::uint8_t* data, std::size_t length,
+                       bool* failed = nullptr) {
+  std::size_t done = 0;
+  while (done < length) {
+    auto n = read(fd, data + done, length - done);
+    if (n > 0) {
+      done += std::size_t(n);
+    } else if (n == 0) {
+      break;
+    } else if (errno != EINTR) {
+      if (failed != nullptr) {
+        *failed = true;
+      }
+      break;
+    }
+  }
+  return done;
+}
+
+// write(2) until all length bytes are written or an error;
+// returns true if everything is written.
+template <typename = int>
+bool write_fully(int fd, const std::uint8_t* data, std::size_t length) {
+  std::size_t done = 0;
+  while (done < length) {
+    auto n = write(fd, data + done, length - done);
+    if (n > 0) {
+      done += std::size_t(n);
+    } else if (n == 0 || errno != EINTR) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// writev(2) the segments in batches until all bytes are written or
+// an error; returns true if everything is written.
+template <typename = int>
+bool writev_fully(int fd, std::vector<struct iovec> segments) {
+#ifdef IOV_MAX
+  constexpr std::size_t batch = IOV_MAX;
+#else
+  constexpr std::size_t batch = 16;
+#endif
+  std::size_t first = 0;
+  while (first < segments.size()) {
+    auto count = std::min(segments.size() - first, batch);
+    auto n = writev(fd, &segments[first], static_cast<int>(count));
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    } else if (n == 0) {
+      return false;
+    }
+    // skip the segments written, and the written head of a partial one.
+    auto written = std::size_t(n);
+    for (; first < segments.size() && written >= segments[first].iov_len;
+           first++) {
+      written -= segments[first].iov_len;
+    }
+    if (written != 0) {
+      segments[first].iov_base
+        = static_cast<std::uint8_t*>(segments[first].iov_base) + written;
+      segments[first].iov_len -= written;
+    }
+  }
+  return true;
+}
+
+/// \publicsection
+/// \class SegmentList
+/// \brief ordered list of byte ranges that are written out as one file
+///        by a gather write, without joining them first;
+///        it does not own the bytes, which must outlive the write.
+class SegmentList {
+ private:
+  std::vector<struct iovec> segments;
+  std::size_t total_length;
+
+ public:
+  SegmentList() : segments{}, total_length(0) {
+    return;
+  }
+
+  /// \fn push_back(const std::uint8_t* data, std::size_t length)
+  /// \brief append a range of bytes
+  /// \param[in] data pointer to the bytes
+  /// \param[in] length length of the bytes
+  void push_back(const std::uint8_t* data, std::size_t length) {
+    if (length == 0) {
+      return;
+    }
+    struct iovec segment;
+    segment.iov_base = const_cast<std::uint8_t*>(data);
+    segment.iov_len = length;
+    segments.push_back(segment);
+    total_length += length;
+    return;
+  }
+
+  /// \fn push_back(const std::vector<std::uint8_t>& data)
+  /// \brief append the bytes of the vector
+  /// \param[in] data the bytes
+  void push_back(const std::vector<std::uint8_t>& data) {
+    push_back(data.data(), data.size());
+    return;
+  }
+
+  /// \fn size()
+  /// \return total length of the segments
+  std::size_t size() const {
+    return total_length;
+  }
+
+  /// \fn get()
+  /// \return the segments as \c std::vector<struct iovec>
+  const std::vector<struct iovec>& get() const {
+    return segments;
+  }
+};
+
+/// \class MappedFile
+/// \brief read-only memory-mapped view of a file;
+///        the contents are paged in on demand instead of being copied.
+class MappedFile {
+ private:
+  const std::uint8_t* address;
+  std::size_t length;
+
+  void unmap() {
+    if (address != nullptr) {
+      munmap(const_cast<std::uint8_t*>(address), length);
+    }
+    address = nullptr;
+    length = 0;
+    return;
+  }
+
+ public:
+  MappedFile() : address(nullptr), length(0) {
+    return;
+  }
+
+  /// \fn MappedFile(const char* name)
+  /// \brief maps the file and hints the kernel to read it ahead
+  ///        sequentially; an empty view is made if the file cannot be mapped.
+  /// \param[in] name name of the file
+  explicit MappedFile(const char* name) : address(nullptr), length(0) {
+    auto fd = open(name, O_RDONLY);
+    if (fd == -1) {
+      return;
+    }
+    struct stat s;
+    if (fstat(fd, &s) == -1 || s.st_size <= 0) {
+      close(fd);
+      return;
+    }
+    auto size = std::size_t(s.st_size);
+    auto p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+      return;
+    }
+    address = static_cast<const std::uint8_t*>(p);
+    length = size;
+    advise(MADV_SEQUENTIAL);
+    advise(MADV_WILLNEED);
+    return;
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /// \fn MappedFile(MappedFile&& other)
+  /// \brief move constructor; \c other becomes empty
+  MappedFile(MappedFile&& other)
+    : address(other.address), length(other.length) {
+    other.address = nullptr;
+    other.length = 0;
+    return;
+  }
+
+  /// \fn operator=(MappedFile&& other)
+  /// \brief move assignment; \c other becomes empty
+  MappedFile& operator=(MappedFile&& other) {
+    if (this != &other) {
+      unmap();
+      std::swap(address, other.address);
+      std::swap(length, other.length);
+    }
+    return *this;
+  }
+
+  ~MappedFile() {
+    unmap();
+    return;
+  }
+
+  /// \fn advise(int advice)
+  /// \brief passes an access pattern hint such as \c MADV_SEQUENTIAL,
+  ///        \c MADV_WILLNEED or \c MADV_RANDOM to the kernel
+  /// \param[in] advice hint for \c madvise(2)
+  void advise(int advice) const {
+    if (address != nullptr) {
+      madvise(const_cast<std::uint8_t*>(address), length, advice);
+    }
+    return;
+  }
+
+  /// \fn data()
+  /// \return pointer to the first byte of the file
+  const std::uint8_t* data() const {
+    return address;
+  }
+
+  /// \fn size()
+  /// \return length of the file
+  std::size_t size() const {
+    return length;
+  }
+
+  /// \fn empty()
+  /// \return true if nothing is mapped
+  bool empty() const {
+    return length == 0;
+  }
+
+  const std::uint8_t* begin() const {
+    return address;
+  }
+
+  const std::uint8_t* end() const {
+    return address + length;
+  }
+
+  const std::uint8_t& operator[](std::size_t i) const {
+    return address[i];
+  }
+
+  /// \fn to_vector()
+  /// \brief copy the contents for the functions that take a vector
+  /// \return \c std::vector<std::uint8_t>
+  std::vector<std::uint8_t> to_vector() const {
+    return std::vector<std::uint8_t>(begin(), end());
+  }
+};
+
 /// \class File
 /// \brief File to vector<std::uint8_t> class
 class File {
@@ -85,10 +348,11 @@ class File {
     }
     struct stat s;
     if (fstat(fd, &s) == -1) {
+      close(fd);
       return buffer;
     }
     buffer.resize(std::size_t(s.st_size));
-    read(fd, &buffer[0], std::size_t(s.st_size));
+    buffer.resize(read_fully(fd, buffer.data(), buffer.size()));
     close(fd);
     return buffer;
   }
@@ -102,6 +366,14 @@ class File {
     return file.get();
   }
 
+  /// \fn map(const char* file_name)
+  /// \brief map the file into memory without copying it
+  /// \param[in] file_name name of the file
+  /// \return \c MappedFile
+  static MappedFile map(const char* file_name) {
+    return MappedFile(file_name);
+  }
+
   /// \fn save(void)
   /// \brief save to the file
   void save() const {
@@ -114,7 +386,7 @@ class File {
     if (fd == -1) {
       return;
     }
-    write(fd, &buffer[0], buffer.size());
+    write_fully(fd, buffer.data(), buffer.size());
     close(fd);
     return;
   }
@@ -140,10 +412,472 @@ class File {
     if (fd == -1) {
       return;
     }
-    write(fd, &buffer[0], buffer.size());
+    write_fully(fd, buffer.data(), buffer.size());
     close(fd);
     return;
   }
+
+  /// \fn save_as(const char* name, const SegmentList& segments)
+  /// \brief save the segments to file in order by gather writes
+  /// \param[in] name file name
+  /// \param[in] segments segments contain to save
+  static void save_as(const char* name, const SegmentList& segments) {
+    auto fd = open(name,
+                   O_CREAT | O_TRUNC | O_WRONLY,
+                   S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd == -1) {
+      return;
+    }
+    writev_fully(fd, segments.get());
+    close(fd);
+    return;
+  }
+};
+
+/// \class FileReader
+/// \brief reads a file block by block;
+///        only one block is resident however large the file is.
+class FileReader {
+ private:
+  int fd;
+  std::size_t block_size;
+  std::vector<std::uint8_t> block;
+  bool end_of_file, failed;
+
+ public:
+  /// \fn FileReader(const char* name, std::size_t block_size)
+  /// \brief Constructor of class FileReader
+  /// \param[in] name name of the file
+  /// \param[in] block_size_ length of each block
+  explicit FileReader(const char* name,
+                      std::size_t block_size_ = std::size_t(1) << 20)
+    : fd(open(name, O_RDONLY)),
+      block_size(block_size_ == 0 ? 1 : block_size_),
+      block{},
+      end_of_file(fd == -1),
+      failed(fd == -1) {
+    block.reserve(block_size);
+    return;
+  }
+
+  FileReader(const FileReader&) = delete;
+  FileReader& operator=(const FileReader&) = delete;
+
+  ~FileReader() {
+    if (fd != -1) {
+      close(fd);
+    }
+    return;
+  }
+
+  /// \fn is_open()
+  /// \return true if the file is opened
+  bool is_open() const {
+    return fd != -1;
+  }
+
+  /// \fn eof()
+  /// \return true if the whole file was read, or reading stopped at
+  ///         an error
+  bool eof() const {
+    return end_of_file;
+  }
+
+  /// \fn good()
+  /// \return false if opening or any read has failed
+  bool good() const {
+    return !failed;
+  }
+
+  /// \fn next()
+  /// \brief read the next block; the buffer is reused by the next call.
+  /// \return the block as \c std::vector<std::uint8_t>, shorter than
+  ///         the block size only at the end of the file, empty after it.
+  const std::vector<std::uint8_t>& next() {
+    block.resize(block_size);
+    std::size_t length = 0;
+    if (!end_of_file) {
+      length = read_fully(fd, block.data(), block_size, &failed);
+      end_of_file = length < block_size;
+    }
+    block.resize(length);
+    return block;
+  }
+};
+
+/// \class FileWriter
+/// \brief writes a file through a fixed-size buffer
+class FileWriter {
+ private:
+  int fd;
+  std::size_t buffer_size;
+  std::vector<std::uint8_t> buffer;
+  bool failed;
+
+ public:
+  /// \fn FileWriter(const char* name, std::size_t buffer_size)
+  /// \brief Constructor of class FileWriter; truncates the file
+  /// \param[in] name name of the file
+  /// \param[in] buffer_size_ length of the buffer
+  explicit FileWriter(const char* name,
+                      std::size_t buffer_size_ = std::size_t(1) << 20)
+    : fd(open(name,
+              O_CREAT | O_TRUNC | O_WRONLY,
+              S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)),
+      buffer_size(buffer_size_),
+      buffer{},
+      failed(fd == -1) {
+    buffer.reserve(buffer_size);
+    return;
+  }
+
+  FileWriter(const FileWriter&) = delete;
+  FileWriter& operator=(const FileWriter&) = delete;
+
+  ~FileWriter() {
+    flush();
+    if (fd != -1) {
+      close(fd);
+    }
+    return;
+  }
+
+  /// \fn good()
+  /// \return false if opening or any write has failed
+  bool good() const {
+    return !failed;
+  }
+
+  /// \fn write(const std::uint8_t* data, std::size_t length)
+  /// \brief append bytes to the file
+  /// \param[in] data pointer to the bytes
+  /// \param[in] length length of the bytes
+  void write(const std::uint8_t* data, std::size_t length) {
+    if (buffer.size() + length <= buffer_size) {
+      buffer.insert(buffer.end(), data, data + length);
+      return;
+    }
+    flush();
+    if (length >= buffer_size) {
+      if (!failed && !write_fully(fd, data, length)) {
+        failed = true;
+      }
+    } else {
+      buffer.insert(buffer.end(), data, data + length);
+    }
+    return;
+  }
+
+  /// \fn write(const std::vector<std::uint8_t>& data)
+  /// \brief append bytes to the file
+  /// \param[in] data the bytes
+  void write(const std::vector<std::uint8_t>& data) {
+    write(data.data(), data.size());
+    return;
+  }
+
+  /// \fn flush()
+  /// \brief write the buffered bytes to the file
+  void flush() {
+    if (!failed && !write_fully(fd, buffer.data(), buffer.size())) {
+      failed = true;
+    }
+    buffer.clear();
+    return;
+  }
+};
+
+/// \class ReadAheadFileReader
+/// \brief reads a file block by block like \c FileReader, while
+///        a background thread already reads the following blocks,
+///        so that the caller's work overlaps with the disk.
+class ReadAheadFileReader {
+ private:
+  int fd;
+  std::size_t block_size;
+  std::vector<std::vector<std::uint8_t>> blocks;
+  std::deque<std::size_t> filled, unused;
+  std::size_t current;
+  bool holding, stopping, end_of_file, failed;
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::thread reader;
+
+  void run() {
+    for (;;) {
+      std::size_t index;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this] { return stopping || !unused.empty(); });
+        if (stopping) {
+          return;
+        }
+        index = unused.front();
+        unused.pop_front();
+      }
+      auto&& block = blocks[index];
+      auto read_failed = false;
+      block.resize(block_size);
+      block.resize(read_fully(fd, block.data(), block_size, &read_failed));
+      auto last = block.size() < block_size;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        failed = failed || read_failed;
+        filled.push_back(index);
+      }
+      condition.notify_all();
+      if (last) {
+        return;
+      }
+    }
+  }
+
+ public:
+  /// \fn ReadAheadFileReader(const char* name, std::size_t block_size,
+  ///                          std::size_t depth)
+  /// \brief Constructor of class ReadAheadFileReader
+  /// \param[in] name name of the file
+  /// \param[in] block_size_ length of each block
+  /// \param[in] depth number of blocks read ahead of the caller
+  explicit ReadAheadFileReader(const char* name,
+                               std::size_t block_size_ = std::size_t(1) << 20,
+                               std::size_t depth = 2)
+    : fd(open(name, O_RDONLY)),
+      block_size(block_size_ == 0 ? 1 : block_size_),
+      blocks(std::max(depth, std::size_t(1)) + 1),
+      filled{},
+      unused{},
+      current(0),
+      holding(false),
+      stopping(false),
+      end_of_file(fd == -1),
+      failed(fd == -1),
+      mutex{},
+      condition{},
+      reader{} {
+    if (fd == -1) {
+      return;
+    }
+    for (std::size_t i = 0; i < blocks.size(); i++) {
+      blocks[i].reserve(block_size);
+      unused.push_back(i);
+    }
+    reader = std::thread(&ReadAheadFileReader::run, this);
+    return;
+  }
+
+  ReadAheadFileReader(const ReadAheadFileReader&) = delete;
+  ReadAheadFileReader& operator=(const ReadAheadFileReader&) = delete;
+
+  ~ReadAheadFileReader() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    condition.notify_all();
+    if (reader.joinable()) {
+      reader.join();
+    }
+    if (fd != -1) {
+      close(fd);
+    }
+    return;
+  }
+
+  /// \fn is_open()
+  /// \return true if the file is opened
+  bool is_open() const {
+    return fd != -1;
+  }
+
+  /// \fn eof()
+  /// \return true if the whole file was handed out, or reading stopped
+  ///         at an error
+  bool eof() const {
+    return end_of_file;
+  }
+
+  /// \fn good()
+  /// \return false if opening or any read has failed
+  bool good() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return !failed;
+  }
+
+  /// \fn next()
+  /// \brief take the next block; the block returned by the previous call
+  ///        goes back to the background reader.
+  /// \return the block as \c std::vector<std::uint8_t>, shorter than
+  ///         the block size only at the end of the file, empty after it.
+  const std::vector<std::uint8_t>& next() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (holding) {
+      blocks[current].clear();
+      unused.push_back(current);
+      holding = false;
+      condition.notify_all();
+    }
+    if (end_of_file) {
+      return blocks[current];
+    }
+    condition.wait(lock, [this] { return !filled.empty(); });
+    current = filled.front();
+    filled.pop_front();
+    holding = true;
+    end_of_file = blocks[current].size() < block_size;
+    return blocks[current];
+  }
+};
+
+/// \class WriteBehindFileWriter
+/// \brief writes a file like \c FileWriter, while a background thread
+///        writes the filled buffers, so that the caller's work overlaps
+///        with the disk.
+class WriteBehindFileWriter {
+ private:
+  int fd;
+  std::size_t block_size;
+  std::vector<std::vector<std::uint8_t>> blocks;
+  std::deque<std::size_t> queued, unused;
+  std::size_t current;
+  bool writing, stopping, failed;
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::thread writer;
+
+  void run() {
+    for (;;) {
+      std::size_t index;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this] { return stopping || !queued.empty(); });
+        if (queued.empty()) {
+          return;
+        }
+        index = queued.front();
+        queued.pop_front();
+        writing = true;
+      }
+      auto&& block = blocks[index];
+      auto written = failed || write_fully(fd, block.data(), block.size());
+      block.clear();
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        failed = failed || !written;
+        unused.push_back(index);
+        writing = false;
+      }
+      condition.notify_all();
+    }
+  }
+
+  // hands the current buffer to the background writer
+  // and waits for an empty one.
+  void submit() {
+    std::unique_lock<std::mutex> lock(mutex);
+    queued.push_back(current);
+    condition.notify_all();
+    condition.wait(lock, [this] { return !unused.empty(); });
+    current = unused.front();
+    unused.pop_front();
+    return;
+  }
+
+ public:
+  /// \fn WriteBehindFileWriter(const char* name, std::size_t block_size,
+  ///                            std::size_t depth)
+  /// \brief Constructor of class WriteBehindFileWriter; truncates the file
+  /// \param[in] name name of the file
+  /// \param[in] block_size_ length of each buffer
+  /// \param[in] depth number of buffers queued for the background writer
+  explicit WriteBehindFileWriter(const char* name,
+                                 std::size_t block_size_
+                                   = std::size_t(1) << 20,
+                                 std::size_t depth = 2)
+    : fd(open(name,
+              O_CREAT | O_TRUNC | O_WRONLY,
+              S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)),
+      block_size(block_size_ == 0 ? 1 : block_size_),
+      blocks(std::max(depth, std::size_t(1)) + 1),
+      queued{},
+      unused{},
+      current(0),
+      writing(false),
+      stopping(false),
+      failed(fd == -1),
+      mutex{},
+      condition{},
+      writer{} {
+    for (std::size_t i = 0; i < blocks.size(); i++) {
+      blocks[i].reserve(block_size);
+      if (i != current) {
+        unused.push_back(i);
+      }
+    }
+    writer = std::thread(&WriteBehindFileWriter::run, this);
+    return;
+  }
+
+  WriteBehindFileWriter(const WriteBehindFileWriter&) = delete;
+  WriteBehindFileWriter& operator=(const WriteBehindFileWriter&) = delete;
+
+  ~WriteBehindFileWriter() {
+    flush();
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    condition.notify_all();
+    writer.join();
+    if (fd != -1) {
+      close(fd);
+    }
+    return;
+  }
+
+  /// \fn good()
+  /// \return false if opening or any write has failed
+  bool good() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return !failed;
+  }
+
+  /// \fn write(const std::uint8_t* data, std::size_t length)
+  /// \brief append bytes to the file
+  /// \param[in] data pointer to the bytes
+  /// \param[in] length length of the bytes
+  void write(const std::uint8_t* data, std::size_t length) {
+    while (length > 0) {
+      auto&& block = blocks[current];
+      auto n = std::min(length, block_size - block.size());
+      block.insert(block.end(), data, data + n);
+      data += n;
+      length -= n;
+      if (block.size() == block_size) {
+        submit();
+      }
+    }
+    return;
+  }
+
+  /// \fn write(const std::vector<std::uint8_t>& data)
+  /// \brief append bytes to the file
+  /// \param[in] data the bytes
+  void write(const std::vector<std::uint8_t>& data) {
+    write(data.data(), data.size());
+    return;
+  }
+
+  /// \fn flush()
+  /// \brief write the buffered bytes and wait until they reach the file
+  void flush() {
+    if (!blocks[current].empty()) {
+      submit();
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [this] { return queued.empty() && !writing; });
+    return;
+  }
 };
 
 }  // namespace ResearchLibrary
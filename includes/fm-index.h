@@ -0,0 +1,271 @@
+// Copyright 2015 pixie.grasper
+/// \file fm-index.h
+/// \brief Implementation of the FM-Index
+/// \author pixie.grasper
+
+#ifndef INCLUDES_FM_INDEX_H_
+#define INCLUDES_FM_INDEX_H_
+
+/// \privatesection
+int gets();
+/// \publicsection
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#ifdef RESEARCHLIB_OFFLINE_TEST
+#include "./size-type.h"
+#include "./burrows-wheeler-transform.h"
+#else
+#include <size-type.h>
+#include <burrows-wheeler-transform.h>
+#endif
+
+/// \namespace ResearchLibrary
+/// \namespace ResearchLibrary::FMIndex
+namespace ResearchLibrary {
+namespace FMIndex {
+
+/// \privatesection
+template <typename = int>
+std::size_t count_ones(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+  return std::size_t(__builtin_popcountll(value));
+#else
+  std::size_t n = 0;
+  for (; value != 0; value &= value - 1) {
+    n++;
+  }
+  return n;
+#endif
+}
+
+/// \publicsection
+/// \class Index
+/// \brief FM-index of a sequence;
+///        the BWT of the sequence terminated by a sentinel, with sampled
+///        occurrence tables for the rank and a sampled suffix array.
+///        \c count takes O(|P|) steps and \c locate takes up to
+///        \c sample_rate more steps per occurrence.
+///        the occurrence tables take about (sigma / 64 + sigma / 8192)
+///        bytes per symbol for sigma distinct symbols, or 4 bytes for 256;
+///        the index suits alphabets of up to a few hundred symbols.
+/// \tparam T type of the symbols
+template <typename T>
+class Index {
+ private:
+  // rows per occurrence checkpoint, and per absolute checkpoint
+  static constexpr std::size_t block_length = 128;
+  static constexpr std::size_t superblock_length = std::size_t(1) << 16;
+
+  std::vector<T> alphabet;
+  // the BWT, and the row that holds the sentinel
+  std::vector<T> bwt;
+  std::size_t sentinel_row;
+  // first row of the suffixes that start with each symbol
+  std::vector<std::size_t> first_rows;
+  // occurrences before every superblock, and before every block counted
+  // from the start of its superblock
+  std::vector<std::size_t> superblocks;
+  std::vector<std::uint16_t> blocks;
+  // rows whose text position is a multiple of interval, and their
+  // positions in the order of the rows
+  std::size_t interval;
+  std::vector<std::uint64_t> sampled;
+  std::vector<std::size_t> sampled_before;
+  std::vector<std::size_t> samples;
+
+  // index of c in the alphabet, or the size of the alphabet if absent
+  std::size_t symbol_index(const T& c) const {
+    auto it = std::lower_bound(alphabet.begin(), alphabet.end(), c);
+    if (it == alphabet.end() || c < *it) {
+      return alphabet.size();
+    }
+    return std::size_t(it - alphabet.begin());
+  }
+
+  // occurrences of the c-th symbol in the rows before row
+  std::size_t rank(std::size_t c, std::size_t row) const {
+    const auto sigma = alphabet.size();
+    auto begin = row / block_length * block_length;
+    auto ret = superblocks[row / superblock_length * sigma + c] +
+               blocks[row / block_length * sigma + c];
+    ret += std::size_t(std::count(bwt.begin() + std::ptrdiff_t(begin),
+                                  bwt.begin() + std::ptrdiff_t(row),
+                                  alphabet[c]));
+    if (begin <= sentinel_row && sentinel_row < row &&
+        !(bwt[sentinel_row] < alphabet[c]) &&
+        !(alphabet[c] < bwt[sentinel_row])) {
+      ret--;
+    }
+    return ret;
+  }
+
+  // the row of the suffix one position before that of row
+  std::size_t last_to_first(std::size_t row) const {
+    auto c = symbol_index(bwt[row]);
+    return first_rows[c] + rank(c, row);
+  }
+
+  bool is_sampled(std::size_t row) const {
+    return (sampled[row / 64] >> (row % 64)) & 1;
+  }
+
+  std::size_t sample_of(std::size_t row) const {
+    auto below = sampled[row / 64] & ((std::uint64_t(1) << (row % 64)) - 1);
+    return samples[sampled_before[row / 64] + count_ones(below)];
+  }
+
+  // rows [first, last) of the suffixes that start with pattern
+  std::pair<std::size_t, std::size_t> range(
+      const std::vector<T>& pattern) const {
+    std::size_t first = 0, last = bwt.size();
+    for (auto k = pattern.size(); k-- > 0 && first < last;) {
+      auto c = symbol_index(pattern[k]);
+      if (c == alphabet.size()) {
+        return std::make_pair(std::size_t(0), std::size_t(0));
+      }
+      first = first_rows[c] + rank(c, first);
+      last = first_rows[c] + rank(c, last);
+    }
+    return std::make_pair(first, std::max(first, last));
+  }
+
+  // the suffixes of the ranks of the symbols are sorted with shorter ones
+  // first on ties, which is the order with a sentinel at the end.
+  template <typename Word>
+  void build(const std::vector<T>& source) {
+    const auto N = source.size();
+    std::vector<Word> ranks(N);
+    alphabet = BurrowsWheelerTransform::symbol_ranks(source, &ranks);
+    const auto sigma = alphabet.size();
+    auto&& suffix_array =
+        BurrowsWheelerTransform::suffix_array_by_induced_sorting(
+            ranks, Word(sigma));
+    // row 0 is the sentinel alone, then the suffixes in order
+    bwt.resize(N + 1);
+    std::vector<Word> bwt_ranks(N + 1);
+    sentinel_row = 0;
+    for (std::size_t row = 0; row <= N; row++) {
+      auto position = row == 0 ? N : std::size_t(suffix_array[row - 1]);
+      if (position == 0) {
+        sentinel_row = row;
+        bwt[row] = alphabet[0];
+      } else {
+        bwt[row] = source[position - 1];
+        bwt_ranks[row] = ranks[position - 1];
+      }
+    }
+    first_rows.assign(sigma + 1, 0);
+    for (auto&& c : ranks) {
+      first_rows[std::size_t(c) + 1]++;
+    }
+    first_rows[0] = 1;
+    for (std::size_t c = 1; c <= sigma; c++) {
+      first_rows[c] += first_rows[c - 1];
+    }
+    // checkpoints up to row N + 1, the end of the last row
+    superblocks.assign(((N + 1) / superblock_length + 1) * sigma, 0);
+    blocks.assign(((N + 1) / block_length + 1) * sigma, 0);
+    std::vector<std::size_t> counts(sigma);
+    for (std::size_t row = 0; row <= N + 1; row++) {
+      if (row % superblock_length == 0) {
+        std::copy(counts.begin(), counts.end(),
+                  superblocks.begin() +
+                  std::ptrdiff_t(row / superblock_length * sigma));
+      }
+      if (row % block_length == 0) {
+        auto base = row / superblock_length * sigma;
+        for (std::size_t c = 0; c < sigma; c++) {
+          blocks[row / block_length * sigma + c]
+              = std::uint16_t(counts[c] - superblocks[base + c]);
+        }
+      }
+      if (row <= N && row != sentinel_row) {
+        counts[bwt_ranks[row]]++;
+      }
+    }
+    sampled.assign(N / 64 + 1, 0);
+    for (std::size_t row = 0; row <= N; row++) {
+      auto position = row == 0 ? N : std::size_t(suffix_array[row - 1]);
+      if (position % interval == 0) {
+        sampled[row / 64] |= std::uint64_t(1) << (row % 64);
+        samples.push_back(position);
+      }
+    }
+    sampled_before.resize(sampled.size());
+    for (std::size_t i = 1; i < sampled.size(); i++) {
+      sampled_before[i] = sampled_before[i - 1] + count_ones(sampled[i - 1]);
+    }
+    return;
+  }
+
+ public:
+  /// \fn Index(const std::vector<T>& source, std::size_t sample_rate)
+  /// \brief Constructor of class Index
+  /// \param[in] source sequence
+  /// \param[in] sample_rate one in \c sample_rate positions of the suffix
+  ///            array is kept; smaller is faster \c locate, larger is
+  ///            smaller index
+  explicit Index(const std::vector<T>& source, std::size_t sample_rate = 32)
+      : alphabet{}, bwt{}, sentinel_row(0), first_rows{},
+        superblocks{}, blocks{}, interval(std::max(sample_rate,
+                                                   std::size_t(1))),
+        sampled{}, sampled_before{}, samples{} {
+    if (source.empty()) {
+      return;
+    } else if (source.size() < (std::size_t(1) << 31)) {
+      build<size_type_t<4>>(source);
+    } else {
+      build<size_type_t<8>>(source);
+    }
+    return;
+  }
+
+  /// \fn size()
+  /// \brief length of the indexed sequence
+  std::size_t size() const {
+    return bwt.empty() ? 0 : bwt.size() - 1;
+  }
+
+  /// \fn count(const std::vector<T>& pattern)
+  /// \brief number of occurrences of a pattern
+  /// \param[in] pattern non-empty sequence to search for
+  /// \return number of the occurrences
+  std::size_t count(const std::vector<T>& pattern) const {
+    if (pattern.empty() || bwt.empty()) {
+      return 0;
+    }
+    auto rows = range(pattern);
+    return rows.second - rows.first;
+  }
+
+  /// \fn locate(const std::vector<T>& pattern)
+  /// \brief positions of the occurrences of a pattern
+  /// \param[in] pattern non-empty sequence to search for
+  /// \return the positions in ascending order as \c std::vector<std::size_t>
+  std::vector<std::size_t> locate(const std::vector<T>& pattern) const {
+    std::vector<std::size_t> ret{};
+    if (pattern.empty() || bwt.empty()) {
+      return ret;
+    }
+    auto rows = range(pattern);
+    ret.reserve(rows.second - rows.first);
+    for (auto row = rows.first; row < rows.second; row++) {
+      std::size_t steps = 0;
+      auto i = row;
+      for (; !is_sampled(i); steps++) {
+        i = last_to_first(i);
+      }
+      ret.push_back(sample_of(i) + steps);
+    }
+    std::sort(ret.begin(), ret.end());
+    return ret;
+  }
+};
+
+}  // namespace FMIndex
+}  // namespace ResearchLibrary
+
+#endif  // INCLUDES_FM_INDEX_H_
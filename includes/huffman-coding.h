@@ -9,6 +9,7 @@
 /// \privatesection
 int gets();
 /// \publicsection
+#include <cstdint>
 #include <iostream>
 #include <vector>
 #include <map>
@@ -87,6 +88,65 @@ auto length_map_to_code_map(const std::map<T, unsigned_integer_t>& length_map) {
   return code_map;
 }
 
+// one entry per window of max_length bits; length 0 marks a window that
+// starts no code.
+template <typename T>
+struct DecodeEntry {
+  T value;
+  std::uint8_t length;
+};
+
+template <typename T>
+struct DecodeTable {
+  std::vector<DecodeEntry<T>> entries;
+  std::size_t max_length;
+};
+
+// table-driven decoder of the codes of code_map as they are read in Order.
+// LSB first, a code arrives reversed and the bits after it fill the top
+// of the window; MSB first, the code fills the top and they the bottom.
+template <BitOrder Order, typename T>
+auto make_decode_table(const std::map<T, std::pair<unsigned_integer_t,
+                                                   unsigned_integer_t>>&
+                           code_map) {
+  DecodeTable<T> table{{}, 0};
+  for (auto it = code_map.begin(); it != code_map.end(); ++it) {
+    table.max_length = std::max(table.max_length,
+                                std::size_t(it->second.first));
+  }
+  table.entries.resize(std::size_t(1) << table.max_length, {T(), 0});
+  for (auto it = code_map.begin(); it != code_map.end(); ++it) {
+    auto length = std::size_t(it->second.first);
+    auto code = std::size_t(it->second.second);
+    // an over-subscribed code from a corrupt stream decodes to nothing
+    if (length == 0 || code >> length != 0) {
+      continue;
+    }
+    DecodeEntry<T> entry{it->first, std::uint8_t(length)};
+    if (Order == BitOrder::LSBFirst) {
+      for (auto i = std::size_t(reverse_bits(code, length));
+           i < table.entries.size(); i += std::size_t(1) << length) {
+        table.entries[i] = entry;
+      }
+    } else {
+      auto first = code << (table.max_length - length);
+      auto last = (code + 1) << (table.max_length - length);
+      std::fill(table.entries.begin() + std::ptrdiff_t(first),
+                table.entries.begin() + std::ptrdiff_t(last), entry);
+    }
+  }
+  return table;
+}
+
+// decodes the next symbol; an entry of length 0 if no code matches.
+template <BitOrder Order, typename T>
+const DecodeEntry<T>& decode_symbol(BytesToBits<8, Order>* buffer,
+                                    const DecodeTable<T>& table) {
+  auto&& entry = table.entries[buffer->peek(table.max_length)];
+  buffer->consume(entry.length);
+  return entry;
+}
+
 template <std::size_t N>
 size_type_t<N> mask(std::size_t n) {
   return (size_type_t<N>(1) << n) - 1;
@@ -374,7 +434,7 @@ auto Decode(const std::vector<std::uint8_t>& data,
   for (auto it = code_map.begin(); it != code_map.end(); ++it) {
     root->insert(it->second.first, it->second.second, it->first);
   }
-  BytesToBits<8> buffer(data);
+  BytesToBits<8> buffer(data.data(), data.size());
   std::vector<T> ret(length);
   for (std::size_t i = 0; i < length; i++) {
     auto current_node = root;
@@ -13,6 +13,7 @@ int gets();
 #include <vector>
 #include <unordered_map>
 #include <type_traits>
+#include <algorithm>
 
 #ifdef RESEARCHLIB_OFFLINE_TEST
 #include "./size-type.h"
@@ -234,33 +235,36 @@ class RasterImage {
     return ret;
   }
 
+  std::vector<std::uint8_t> append_png_chunk(
+      std::vector<std::uint8_t>&& buffer,
+      const char* type,
+      const std::vector<std::uint8_t>& data) {
+    auto index = buffer.size();
+    buffer.resize(index + 4 + 4 + data.size() + 4);
+    buffer = writebe<4>(std::move(buffer), index, size_type_t<4>(data.size()));
+    for (std::size_t i = 0; i < 4; i++) {
+      buffer[index + 4 + i] = static_cast<std::uint8_t>(type[i]);
+    }
+    std::copy(data.begin(), data.end(), &buffer[index + 8]);
+    // the crc covers the chunk type and the data, already in place.
+    CheckSum::CRC32Hasher<> crc{};
+    crc.update(&buffer[index + 4], 4 + data.size());
+    buffer = writebe<4>(std::move(buffer), index + 8 + data.size(),
+                        crc.finish());
+    return std::move(buffer);
+  }
+
   void save_as_png16a(const char* file_name) {
     std::vector<std::uint8_t> buffer = {137, 80, 78, 71, 13, 10, 26, 10};
-    std::vector<std::uint8_t> IHDR(8 + 17), IHDR_data(17);
-    IHDR = writebe<4>(std::move(IHDR), 0, 13);
-    IHDR_data[0] = 'I';
-    IHDR_data[1] = 'H';
-    IHDR_data[2] = 'D';
-    IHDR_data[3] = 'R';
-    IHDR_data = writebe<4>(std::move(IHDR_data), 4, size_type_t<4>(width()));
-    IHDR_data = writebe<4>(std::move(IHDR_data), 8, size_type_t<4>(height()));
-    IHDR_data[12] = 16;  // Bit depth
-    IHDR_data[13] = 6;  // Color type = R, G, B, Alpha
-    IHDR_data[14] = 0;  // Compression method
-    IHDR_data[15] = 0;  // Filter method
-    IHDR_data[16] = 0;  // Interlace method
-    for (std::size_t i = 0; i < IHDR_data.size(); i++) {
-      IHDR[i + 4] = IHDR_data[i];
-    }
-    IHDR = writebe<4>(std::move(IHDR),
-                      IHDR.size() - 4,
-                      CheckSum::CRC32(IHDR_data, 0));
-    buffer.insert(buffer.end(), IHDR.begin(), IHDR.end());
-    std::vector<std::uint8_t> IDAT_data(4);
-    IDAT_data[0] = 'I';
-    IDAT_data[1] = 'D';
-    IDAT_data[2] = 'A';
-    IDAT_data[3] = 'T';
+    std::vector<std::uint8_t> IHDR(13);
+    IHDR = writebe<4>(std::move(IHDR), 0, size_type_t<4>(width()));
+    IHDR = writebe<4>(std::move(IHDR), 4, size_type_t<4>(height()));
+    IHDR[8] = 16;  // Bit depth
+    IHDR[9] = 6;  // Color type = R, G, B, Alpha
+    IHDR[10] = 0;  // Compression method
+    IHDR[11] = 0;  // Filter method
+    IHDR[12] = 0;  // Interlace method
+    buffer = append_png_chunk(std::move(buffer), "IHDR", IHDR);
     std::vector<std::uint8_t> source_buffer(8 * width() * height() + height());
     for (std::size_t y = 0; y < height(); y++) {
       source_buffer[y * width() * 8 + y] = 0;
@@ -278,39 +282,33 @@ class RasterImage {
       }
     }
     auto compressed_data = Deflate::Encode(source_buffer);
-    std::vector<std::uint8_t> zlib_form(6 + compressed_data.size());
-    zlib_form[0] = 0x78;
-    zlib_form[1] = 0xda;
-    for (std::size_t i = 0; i < compressed_data.size(); i++) {
-      zlib_form[i + 2] = compressed_data[i];
-    }
-    zlib_form = writebe<4>(std::move(zlib_form),
-                           zlib_form.size() - 4,
-                           CheckSum::Adler32(source_buffer, 1));
-    IDAT_data.insert(IDAT_data.end(), zlib_form.begin(), zlib_form.end());
-    std::vector<std::uint8_t> IDAT(8 + IDAT_data.size());
-    IDAT = writebe<4>(std::move(IDAT), 0, size_type_t<4>(IDAT_data.size() - 4));
-    for (std::size_t i = 0; i < IDAT_data.size(); i++) {
-      IDAT[i + 4] = IDAT_data[i];
-    }
-    IDAT = writebe<4>(std::move(IDAT),
-                      IDAT.size() - 4,
-                      CheckSum::CRC32(IDAT_data, 0));
-    buffer.insert(buffer.end(), IDAT.begin(), IDAT.end());
-    std::vector<std::uint8_t> IEND(8 + 4), IEND_data(4);
-    IEND = writebe<4>(std::move(IEND), 0, 0);
-    IEND_data[0] = 'I';
-    IEND_data[1] = 'E';
-    IEND_data[2] = 'N';
-    IEND_data[3] = 'D';
-    for (std::size_t i = 0; i < IEND_data.size(); i++) {
-      IEND[i + 4] = IEND_data[i];
-    }
-    IEND = writebe<4>(std::move(IEND),
-                      IEND.size() - 4,
-                      CheckSum::CRC32(IEND_data, 0));
-    buffer.insert(buffer.end(), IEND.begin(), IEND.end());
-    File::save_as(file_name, buffer);
+    // the compressed data is written in place between the framing bytes;
+    // IDAT = length, type, zlib header, compressed data, adler-32, crc.
+    auto IDAT_length = 2 + compressed_data.size() + 4;
+    auto index = buffer.size();
+    buffer.resize(index + 4 + 4 + 2);
+    buffer = writebe<4>(std::move(buffer), index,
+                        size_type_t<4>(IDAT_length));
+    buffer[index + 4] = 'I';
+    buffer[index + 5] = 'D';
+    buffer[index + 6] = 'A';
+    buffer[index + 7] = 'T';
+    buffer[index + 8] = 0x78;
+    buffer[index + 9] = 0xda;
+    std::vector<std::uint8_t> trailer(4 + 4);
+    trailer = writebe<4>(std::move(trailer), 0,
+                         CheckSum::Adler32(source_buffer, 1));
+    CheckSum::CRC32Hasher<> crc{};
+    crc.update(&buffer[index + 4], 4 + 2);
+    crc.update(compressed_data);
+    crc.update(trailer.data(), 4);
+    trailer = writebe<4>(std::move(trailer), 4, crc.finish());
+    trailer = append_png_chunk(std::move(trailer), "IEND", {});
+    SegmentList segments{};
+    segments.push_back(buffer);
+    segments.push_back(compressed_data);
+    segments.push_back(trailer);
+    File::save_as(file_name, segments);
     return;
   }
 
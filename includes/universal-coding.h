@@ -49,11 +49,9 @@ auto UnaryCodingEncode(const std::vector<T>& data) {
 template <typename T>
 auto UnaryCodingDecode(const std::vector<uint8_t>& data, std::size_t length) {
   std::vector<T> ret(length);
-  BytesToBits<8> buffer(data);
+  BytesToBits<8> buffer(data.data(), data.size());
   for (std::size_t i = 0; i < length; i++) {
-    T value{};
-    for (; buffer.get(1) != 1; value++) {}
-    ret[i] = std::move(value);
+    ret[i] = T(buffer.get_unary());
   }
   return ret;
 }
@@ -97,10 +95,9 @@ auto GammaCodingEncode(const std::vector<T>& data) {
 template <typename T>
 auto GammaCodingDecode(const std::vector<uint8_t>& data, std::size_t length) {
   std::vector<T> ret(length);
-  BytesToBits<8> buffer(data);
+  BytesToBits<8> buffer(data.data(), data.size());
   for (std::size_t i = 0; i < length; i++) {
-    unsigned_integer_t width = 0;
-    for (; buffer.get(1) != 1; width++) {}
+    auto width = buffer.get_unary();
     ret[i] = T(buffer.rget(width, 1));
   }
   return ret;
@@ -147,10 +144,9 @@ auto DeltaCodingEncode(const std::vector<T>& data) {
 template <typename T>
 auto DeltaCodingDecode(const std::vector<uint8_t>& data, std::size_t length) {
   std::vector<T> ret(length);
-  BytesToBits<8> buffer(data);
+  BytesToBits<8> buffer(data.data(), data.size());
   for (std::size_t i = 0; i < length; i++) {
-    unsigned_integer_t width_of_width = 0;
-    for (; buffer.get(1) != 1; width_of_width++) {}
+    auto width_of_width = buffer.get_unary();
     auto width = buffer.rget(width_of_width, 1);
     ret[i] = T(buffer.rget(width - 1, 1));
   }
@@ -205,7 +201,7 @@ auto OmegaCodingEncode(const std::vector<T>& data) {
 template <typename T>
 auto OmegaCodingDecode(const std::vector<uint8_t>& data, std::size_t length) {
   std::vector<T> ret(length);
-  BytesToBits<8> buffer(data);
+  BytesToBits<8> buffer(data.data(), data.size());
   for (std::size_t i = 0; i < length; i++) {
     size_type_t<8> n = 1;
     while (buffer.get(1) != 0) {
@@ -285,12 +281,12 @@ auto GolombCodingDecode(const std::vector<uint8_t>& data,
                         const T& m,
                         std::size_t length) {
   std::vector<T> ret(length);
-  BytesToBits<8> buffer(data);
+  BytesToBits<8> buffer(data.data(), data.size());
   auto b = T(std::ceil(std::log2(m)));
   if ((m & (m - 1)) == 0) {
     for (std::size_t i = 0; i < length; i++) {
-      T q{}, r{};
-      for (; buffer.get(1) != 1; q++) {}
+      auto q = T(buffer.get_unary());
+      T r{};
       r = T(buffer.rget(size_t(b)));
       ret[i] = q * m + r;
     }
@@ -298,8 +294,8 @@ auto GolombCodingDecode(const std::vector<uint8_t>& data,
     auto bb = (T(1) << b) - m;
     auto c = b - 1;
     for (std::size_t i = 0; i < length; i++) {
-      T q{}, r{};
-      for (; buffer.get(1) != 1; q++) {}
+      auto q = T(buffer.get_unary());
+      T r{};
       r = T(buffer.rget(size_t(c)));
       if (r >= bb) {
         r = (r << 1) + T(buffer.get(1));
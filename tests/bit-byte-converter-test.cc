@@ -1,5 +1,10 @@
 // Copyright 2015 pixie.grasper
 
+#include <cstdlib>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
 #include "../includes/bit-byte-converter.h"
 
 int main() {
@@ -18,5 +23,263 @@ int main() {
     }
   }
 
+  // compare against packing one bit at a time
+  unsigned int seed = 10;
+  std::vector<std::uint64_t> values(10000);
+  std::vector<std::size_t> lengths(values.size());
+  ResearchLibrary::BitsToBytes<8> packed(16);
+  std::vector<std::uint8_t> expected{};
+  std::size_t bit_index = 0;
+  for (std::size_t i = 0; i < values.size(); i++) {
+    lengths[i] = std::size_t(rand_r(&seed)) % 57;
+    values[i] = std::uint64_t(rand_r(&seed)) << 32
+              | std::uint64_t(rand_r(&seed));
+    values[i] &= (std::uint64_t(1) << lengths[i]) - 1;
+    packed.put(values[i], lengths[i]);
+    for (std::size_t j = 0; j < lengths[i]; j++, bit_index++) {
+      if (bit_index % 8 == 0) {
+        expected.push_back(0);
+      }
+      expected.back() = static_cast<std::uint8_t>(
+          expected.back() | ((values[i] >> j) & 1) << (bit_index % 8));
+    }
+  }
+  auto&& packed_buffer = packed.seek_to_byte_boundary();
+  if (packed_buffer != expected) {
+    return 1;
+  }
+  ResearchLibrary::BytesToBits<8> unpacked(packed_buffer);
+  for (std::size_t i = 0; i < values.size(); i++) {
+    if (unpacked.get(lengths[i]) != values[i]) {
+      return 1;
+    }
+  }
+
+  // peek/consume and fetch
+  ResearchLibrary::BytesToBits<8> reader(packed_buffer);
+  for (std::size_t i = 0; i < values.size(); i++) {
+    if (reader.fetch(lengths[i]) != values[i] ||
+        reader.peek(lengths[i]) != values[i]) {
+      return 1;
+    }
+    reader.consume(lengths[i]);
+  }
+  if (reader.get(64) != 0) {
+    return 1;
+  }
+
+  // seek to byte-boundary drops only the rest of the current byte
+  ResearchLibrary::BytesToBits<8> aligned(expected);
+  aligned.get(3);
+  aligned.seek_to_byte_boundary();
+  if (aligned.get(8) != expected[1]) {
+    return 1;
+  }
+  aligned.seek_to_byte_boundary();
+  if (aligned.get(16) != (std::uint64_t(expected[3]) << 8 | expected[2])) {
+    return 1;
+  }
+
+  // reversed bits against the bit-by-bit definition
+  ResearchLibrary::BitsToBytes<8> reversed{};
+  ResearchLibrary::BitsToBytes<8> reversed_reference{};
+  for (std::size_t i = 0; i < values.size(); i++) {
+    reversed.rput(values[i], lengths[i]);
+    for (std::size_t j = 1; j <= lengths[i]; j++) {
+      reversed_reference.put(values[i] >> (lengths[i] - j), 1);
+    }
+  }
+  auto&& reversed_buffer = reversed.seek_to_byte_boundary();
+  if (reversed_buffer != reversed_reference.seek_to_byte_boundary()) {
+    return 1;
+  }
+  ResearchLibrary::BytesToBits<8> reversed_reader(reversed_buffer);
+  for (std::size_t i = 0; i < values.size(); i++) {
+    auto upper = std::uint64_t(i % 4);
+    auto expected_value = upper << lengths[i] | values[i];
+    if (i % 2 == 0 && reversed_reader.rget(lengths[i]) != values[i]) {
+      return 1;
+    }
+    if (i % 2 == 1 &&
+        reversed_reader.rget(lengths[i], upper) != expected_value) {
+      return 1;
+    }
+  }
+
+  // borrowed memory, copies and end of input
+  std::uint8_t raw[3] = {0xa5, 0x5a, 0xff};
+  ResearchLibrary::BytesToBits<8> borrowed(raw, sizeof(raw));
+  if (borrowed.get(12) != 0xaa5 || borrowed.overrun()) {
+    return 1;
+  }
+  auto copied = borrowed;
+  if (copied.get(12) != 0xff5 || copied.overrun()) {
+    return 1;
+  }
+  if (copied.get(1) != 0 || !copied.overrun()) {
+    return 1;
+  }
+  if (borrowed.get(12) != 0xff5 || borrowed.overrun()) {
+    return 1;
+  }
+  std::vector<std::uint8_t> raw_vector(raw, raw + sizeof(raw));
+  ResearchLibrary::BytesToBits<8> owner(raw_vector);
+  auto owner_copy = owner;
+  owner = ResearchLibrary::BytesToBits<8>(std::vector<std::uint8_t>{});
+  if (owner_copy.get(24) != 0xff5aa5 || owner.get(8) != 0) {
+    return 1;
+  }
+
+  // most significant bit first
+  using ResearchLibrary::BitOrder;
+  ResearchLibrary::BitsToBytes<8, BitOrder::MSBFirst> msb_packed{};
+  std::vector<std::uint8_t> msb_expected{};
+  bit_index = 0;
+  for (std::size_t i = 0; i < values.size(); i++) {
+    msb_packed.put(values[i], lengths[i]);
+    for (std::size_t j = 1; j <= lengths[i]; j++, bit_index++) {
+      if (bit_index % 8 == 0) {
+        msb_expected.push_back(0);
+      }
+      auto bit = (values[i] >> (lengths[i] - j)) & 1;
+      msb_expected.back() = static_cast<std::uint8_t>(
+          msb_expected.back() | bit << (7 - bit_index % 8));
+    }
+  }
+  msb_packed.put(0x0123456789abcdef, 64);
+  for (std::size_t i = 0; i < 8; i++) {
+    auto byte = std::uint64_t(0x0123456789abcdef) >> (56 - i * 8);
+    for (std::size_t j = 0; j < 8; j++, bit_index++) {
+      if (bit_index % 8 == 0) {
+        msb_expected.push_back(0);
+      }
+      auto bit = (byte >> (7 - j)) & 1;
+      msb_expected.back() = static_cast<std::uint8_t>(
+          msb_expected.back() | bit << (7 - bit_index % 8));
+    }
+  }
+  auto&& msb_buffer = msb_packed.seek_to_byte_boundary();
+  if (msb_buffer != msb_expected) {
+    return 1;
+  }
+  ResearchLibrary::BytesToBits<8, BitOrder::MSBFirst> msb_reader(msb_buffer);
+  for (std::size_t i = 0; i < values.size(); i++) {
+    if (msb_reader.fetch(lengths[i]) != values[i] ||
+        msb_reader.peek(lengths[i]) != values[i]) {
+      return 1;
+    }
+    msb_reader.consume(lengths[i]);
+  }
+  if (msb_reader.fetch(64) != 0x0123456789abcdef ||
+      msb_reader.get(64) != 0x0123456789abcdef ||
+      msb_reader.overrun()) {
+    return 1;
+  }
+  ResearchLibrary::BitsToBytes<8, BitOrder::MSBFirst> msb_reversed{};
+  msb_reversed.rput(0x1, 4);
+  msb_reversed.rput(0x3, 3);
+  auto&& msb_reversed_buffer = msb_reversed.seek_to_byte_boundary();
+  if (msb_reversed_buffer.size() != 1 || msb_reversed_buffer[0] != 0x8c) {
+    return 1;
+  }
+  ResearchLibrary::BytesToBits<8, BitOrder::MSBFirst>
+      msb_reversed_reader(msb_reversed_buffer);
+  if (msb_reversed_reader.rget(4) != 0x1 ||
+      msb_reversed_reader.rget(3, 1) != 0xb) {
+    return 1;
+  }
+
+  // unary runs, including ones longer than a word
+  std::vector<std::size_t> runs(1000);
+  ResearchLibrary::BitsToBytes<8> unary{};
+  ResearchLibrary::BitsToBytes<8, BitOrder::MSBFirst> msb_unary{};
+  for (std::size_t i = 0; i < runs.size(); i++) {
+    runs[i] = std::size_t(rand_r(&seed)) % (i % 10 == 0 ? 300 : 10);
+    for (std::size_t j = 0; j < runs[i]; j++) {
+      unary.put(0, 1);
+      msb_unary.put(0, 1);
+    }
+    unary.put(1, 1);
+    msb_unary.put(1, 1);
+    unary.put(i, 3);
+    msb_unary.put(i, 3);
+  }
+  ResearchLibrary::BytesToBits<8> unary_reader(unary.seek_to_byte_boundary());
+  ResearchLibrary::BytesToBits<8, BitOrder::MSBFirst>
+      msb_unary_reader(msb_unary.seek_to_byte_boundary());
+  for (std::size_t i = 0; i < runs.size(); i++) {
+    if (unary_reader.get_unary() != runs[i] ||
+        unary_reader.get(3) != (i & 7) ||
+        msb_unary_reader.get_unary() != runs[i] ||
+        msb_unary_reader.get(3) != (i & 7)) {
+      return 1;
+    }
+  }
+  if (unary_reader.overrun() || msb_unary_reader.overrun()) {
+    return 1;
+  }
+  unary_reader.get_unary();
+  if (!unary_reader.overrun()) {
+    return 1;
+  }
+
+  // writing into a fixed buffer
+  std::vector<std::uint8_t> fixed(expected.size());
+  ResearchLibrary::BitsToBuffer<8> fixed_writer(fixed.data(), fixed.size());
+  for (std::size_t round = 0; round < 2; round++) {
+    for (std::size_t i = 0; i < values.size(); i++) {
+      fixed_writer.put(values[i], lengths[i]);
+    }
+    if (fixed_writer.seek_to_byte_boundary() != fixed.size() ||
+        fixed_writer.overflow() || fixed != expected) {
+      return 1;
+    }
+    fixed_writer.put(1, 1);
+    fixed_writer.reset();
+    fixed.assign(fixed.size(), 0);
+  }
+  std::vector<std::uint8_t> small(5);
+  fixed_writer.reset(small.data(), small.size());
+  for (std::size_t i = 0; i < values.size(); i++) {
+    fixed_writer.put(values[i], lengths[i]);
+  }
+  if (fixed_writer.seek_to_byte_boundary() != small.size() ||
+      !fixed_writer.overflow() ||
+      !std::equal(small.begin(), small.end(), expected.begin())) {
+    return 1;
+  }
+
+  // an overflowing buffer holds a prefix of the stream in both orders,
+  // cut in the middle of a word or of the last bytes
+  std::vector<std::size_t> capacities{1, 3, 7, 9, 13, expected.size() - 1};
+  for (auto&& capacity : capacities) {
+    std::vector<std::uint8_t> lsb_prefix(capacity), msb_prefix(capacity);
+    ResearchLibrary::BitsToBuffer<8> lsb_writer(lsb_prefix.data(), capacity);
+    ResearchLibrary::BitsToBuffer<8, BitOrder::MSBFirst>
+        msb_writer(msb_prefix.data(), capacity);
+    for (std::size_t i = 0; i < values.size(); i++) {
+      lsb_writer.put(values[i], lengths[i]);
+      msb_writer.put(values[i], lengths[i]);
+    }
+    msb_writer.put(0x0123456789abcdef, 64);
+    if (lsb_writer.seek_to_byte_boundary() != capacity ||
+        msb_writer.seek_to_byte_boundary() != capacity ||
+        !lsb_writer.overflow() || !msb_writer.overflow() ||
+        !std::equal(lsb_prefix.begin(), lsb_prefix.end(), expected.begin()) ||
+        !std::equal(msb_prefix.begin(), msb_prefix.end(),
+                    msb_expected.begin())) {
+      return 1;
+    }
+  }
+  std::uint8_t tail[3] = {};
+  ResearchLibrary::BitsToBuffer<8, BitOrder::MSBFirst>
+      tail_writer(tail, sizeof(tail));
+  tail_writer.put(0xabcdef12345, 44);
+  if (tail_writer.seek_to_byte_boundary() != sizeof(tail) ||
+      !tail_writer.overflow() ||
+      tail[0] != 0xab || tail[1] != 0xcd || tail[2] != 0xef) {
+    return 1;
+  }
+
   return 0;
 }
@@ -0,0 +1,65 @@
+// Copyright 2015 pixie.grasper
+
+#include <cstdlib>
+#include <cstdint>
+#include <vector>
+
+#include "../includes/block-sorting.h"
+
+int main() {
+  // words over a small alphabet with long repeats, and a run of one byte
+  std::vector<std::uint8_t> buffer{};
+  unsigned int seed = 10;
+  while (buffer.size() < 100000) {
+    if (rand_r(&seed) % 50 == 0 && buffer.size() > 1000) {
+      auto start = buffer.size() - std::size_t(rand_r(&seed) % 1000) - 1;
+      auto length = std::size_t(rand_r(&seed) % 200);
+      for (std::size_t i = 0; i < length; i++) {
+        buffer.push_back(buffer[start + i]);
+      }
+    } else {
+      buffer.push_back(std::uint8_t('a' + rand_r(&seed) % 20));
+    }
+  }
+  buffer.insert(buffer.end(), 5000, 0xff);
+
+  using ResearchLibrary::BlockSorting::Encode;
+  using ResearchLibrary::BlockSorting::Decode;
+  for (std::size_t block_size : {1u, 100u, 30000u, 900000u}) {
+    std::vector<std::uint8_t> source(buffer.begin(),
+                                     block_size == 1 ? buffer.begin() + 1000
+                                                     : buffer.end());
+    auto&& encoded = Encode(source, block_size, block_size % 3 + 1);
+    if (Decode(encoded, block_size % 4 + 1) != source ||
+        (block_size > 100 && encoded.size() * 3 > source.size())) {
+      return 1;
+    }
+  }
+
+  // an oversized block length is clamped, and random bytes stay within
+  // the bound that keeps the block length in 4 bytes
+  std::vector<std::uint8_t> noise(20000);
+  for (auto&& c : noise) {
+    c = std::uint8_t(rand_r(&seed));
+  }
+  auto&& noise_encoded = Encode(noise, ~std::size_t(0));
+  if (Decode(noise_encoded) != noise ||
+      noise_encoded.size() * 10 > noise.size() * 22) {
+    return 1;
+  }
+
+  // an empty sequence, and broken data gives an empty sequence
+  if (!Decode(Encode(std::vector<std::uint8_t>())).empty()) {
+    return 1;
+  }
+  auto&& encoded = Encode(buffer, 30000);
+  encoded[encoded.size() / 2] ^= 0x10;
+  if (!Decode(encoded).empty()) {
+    return 1;
+  }
+  encoded.resize(encoded.size() / 3);
+  if (!Decode(encoded).empty()) {
+    return 1;
+  }
+  return 0;
+}
@@ -1,6 +1,8 @@
 // Copyright 2015 pixie.grasper
 
 #include <cstdlib>
+#include <cstdint>
+#include <string>
 #include <vector>
 
 #include "../includes/burrows-wheeler-transform.h"
@@ -18,5 +20,97 @@ int main() {
       return 1;
     }
   }
+
+  // every sorter gives the same transform
+  using ResearchLibrary::BurrowsWheelerTransform::SuffixSorter;
+  std::vector<std::vector<int>> sources{buffer, std::vector<int>(100, 7)};
+  for (std::size_t i = 0; i < 100; i++) {
+    std::vector<int> source(std::size_t(rand_r(&seed)) % 300 + 1);
+    for (std::size_t j = 0; j < source.size(); j++) {
+      source[j] = j < 3 ? rand_r(&seed) % 3 - 1 : source[j - 3 + i % 3];
+    }
+    sources.push_back(std::move(source));
+  }
+  for (auto&& source : sources) {
+    auto&& reference = ResearchLibrary::BurrowsWheelerTransform::BWT(source);
+    auto&& induced = ResearchLibrary::BurrowsWheelerTransform
+                   ::BWT<SuffixSorter::InducedSorting>(source);
+    std::vector<std::size_t> no_restarts{};
+    auto&& wide_index = ResearchLibrary::BurrowsWheelerTransform
+                      ::BWT_with_index_type<SuffixSorter::InducedSorting,
+                                            std::uint64_t>(source, 1,
+                                                           &no_restarts);
+    auto&& parallel = ResearchLibrary::BurrowsWheelerTransform
+                    ::ParallelBWT(source, source.size() % 4 + 1);
+    if (induced != reference || wide_index != reference ||
+        parallel != reference ||
+        ResearchLibrary::BurrowsWheelerTransform::IBWT(reference) != source) {
+      return 1;
+    }
+
+    // the walks from the restart points give the same sequence
+    for (std::size_t samples : {1u, 2u, 7u, 64u, 1000u}) {
+      auto&& sampled = ResearchLibrary::BurrowsWheelerTransform
+                     ::SampledBWT(source, samples);
+      if (sampled.first != reference ||
+          ResearchLibrary::BurrowsWheelerTransform
+          ::IBWT(sampled, samples % 3 + 1) != source) {
+        return 1;
+      }
+    }
+  }
+
+  // symbols that are not small integers, and an index out of range
+  std::vector<std::string> words{"pixie", "grasper", "pixie", "research"};
+  auto&& word_bwt = ResearchLibrary::BurrowsWheelerTransform::BWT(words);
+  if (ResearchLibrary::BurrowsWheelerTransform::IBWT(word_bwt) != words ||
+      !ResearchLibrary::BurrowsWheelerTransform::IBWT(word_bwt.first,
+                                                      words.size()).empty()) {
+    return 1;
+  }
+  auto&& bad_restart = ResearchLibrary::BurrowsWheelerTransform
+                     ::SampledBWT(words, 2);
+  bad_restart.second[1] = words.size();
+  if (!ResearchLibrary::BurrowsWheelerTransform::IBWT(bad_restart).empty()) {
+    return 1;
+  }
+  auto&& induced_words = ResearchLibrary::BurrowsWheelerTransform
+                       ::BWT<SuffixSorter::InducedSorting>(words);
+  if (induced_words != word_bwt ||
+      ResearchLibrary::BurrowsWheelerTransform::ParallelBWT(words, 2)
+      != word_bwt) {
+    return 1;
+  }
+
+  // small signed symbols, ranked through a table of their values
+  std::vector<std::int8_t> narrow(5000);
+  std::vector<std::int16_t> wide(5000);
+  std::vector<int> as_int(5000);
+  for (std::size_t i = 0; i < narrow.size(); i++) {
+    narrow[i] = std::int8_t(rand_r(&seed) % 200 - 100);
+    wide[i] = std::int16_t(narrow[i] * 300);
+    as_int[i] = narrow[i];
+  }
+  auto&& int_bwt = ResearchLibrary::BurrowsWheelerTransform::BWT(as_int);
+  auto&& narrow_bwt = ResearchLibrary::BurrowsWheelerTransform
+                    ::BWT<SuffixSorter::InducedSorting>(narrow);
+  auto&& wide_bwt = ResearchLibrary::BurrowsWheelerTransform
+                  ::BWT<SuffixSorter::InducedSorting>(wide);
+  if (narrow_bwt.second != int_bwt.second ||
+      wide_bwt.second != int_bwt.second ||
+      ResearchLibrary::BurrowsWheelerTransform::IBWT(narrow_bwt) != narrow ||
+      ResearchLibrary::BurrowsWheelerTransform::IBWT(wide_bwt) != wide ||
+      ResearchLibrary::BurrowsWheelerTransform::ParallelBWT(narrow, 3)
+      != narrow_bwt ||
+      ResearchLibrary::BurrowsWheelerTransform::ParallelBWT(wide, 2)
+      != wide_bwt) {
+    return 1;
+  }
+  for (std::size_t i = 0; i < narrow.size(); i++) {
+    if (narrow_bwt.first[i] != int_bwt.first[i] ||
+        wide_bwt.first[i] != int_bwt.first[i] * 300) {
+      return 1;
+    }
+  }
   return 0;
 }
@@ -1,7 +1,133 @@
 // Copyright 2015 pixie.grasper
 
+#include <cstdlib>
+#include <cstdint>
+#include <vector>
+#include <list>
+#include <algorithm>
+
 #include "../includes/check-sum.h"
 
+std::uint32_t reference_adler32(const std::vector<std::uint8_t>& data,
+                                std::uint32_t start) {
+  auto s1 = start & 0xffff;
+  auto s2 = (start >> 16) & 0xffff;
+  for (std::size_t i = 0; i < data.size(); i++) {
+    s1 = (s1 + data[i]) % 65521;
+    s2 = (s2 + s1) % 65521;
+  }
+  return (s2 << 16) + s1;
+}
+
+std::uint32_t reference_crc32c(const std::vector<std::uint8_t>& data,
+                               std::uint32_t start) {
+  auto c = ~start;
+  for (std::size_t i = 0; i < data.size(); i++) {
+    c ^= data[i];
+    for (std::size_t j = 0; j < 8; j++) {
+      c = (c & 1) != 0 ? 0x82F63B78 ^ (c >> 1) : c >> 1;
+    }
+  }
+  return ~c;
+}
+
 int main() {
+  std::vector<std::uint8_t> check{'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  if (ResearchLibrary::CheckSum::CRC32(check, 0) != 0xcbf43926) {
+    return 1;
+  }
+  if (ResearchLibrary::CheckSum::Adler32(check, 1) != 0x091e01de) {
+    return 1;
+  }
+  if (ResearchLibrary::CheckSum::CRC32C(check, 0) != 0xe3069283) {
+    return 1;
+  }
+
+  std::vector<std::uint8_t> buffer(10007);
+  unsigned int seed = 10;
+  for (std::size_t i = 0; i < buffer.size(); i++) {
+    buffer[i] = static_cast<std::uint8_t>(rand_r(&seed));
+  }
+  auto crc = ResearchLibrary::CheckSum::CRC32<1>(buffer, 0);
+  if (ResearchLibrary::CheckSum::CRC32<4>(buffer, 0) != crc ||
+      ResearchLibrary::CheckSum::CRC32<8>(buffer, 0) != crc ||
+      ResearchLibrary::CheckSum::CRC32<16>(buffer, 0) != crc ||
+      ResearchLibrary::CheckSum::CRC32(buffer, 0) != crc) {
+    return 1;
+  }
+  for (std::size_t length = 0; length < 300; length++) {
+    std::vector<std::uint8_t> part(&buffer[1], &buffer[1] + length);
+    if (ResearchLibrary::CheckSum::CRC32(part, length) !=
+        ResearchLibrary::CheckSum::CRC32<1>(part, length)) {
+      return 1;
+    }
+    auto start = static_cast<std::uint32_t>(rand_r(&seed)) % 65521 * 65537;
+    if (ResearchLibrary::CheckSum::Adler32(part, start) !=
+        reference_adler32(part, start)) {
+      return 1;
+    }
+  }
+  if (ResearchLibrary::CheckSum::Adler32(buffer, 1) !=
+      reference_adler32(buffer, 1)) {
+    return 1;
+  }
+  std::vector<std::uint8_t> saturated(20000, 0xff);
+  if (ResearchLibrary::CheckSum::Adler32(saturated, 0xfff0fff0) !=
+      reference_adler32(saturated, 0xfff0fff0)) {
+    return 1;
+  }
+
+  std::vector<std::uint8_t> large(std::size_t(1) << 20);
+  for (std::size_t i = 0; i < large.size(); i++) {
+    large[i] = static_cast<std::uint8_t>(rand_r(&seed));
+  }
+  for (std::size_t length = 0; length < 30000; length += 761) {
+    std::vector<std::uint8_t> part(&large[3], &large[3] + length);
+    if (ResearchLibrary::CheckSum::CRC32C(part, length) !=
+        reference_crc32c(part, std::uint32_t(length))) {
+      return 1;
+    }
+  }
+  auto large_crc = ResearchLibrary::CheckSum::CRC32(large, 0);
+  auto large_adler = ResearchLibrary::CheckSum::Adler32(large, 1);
+  for (std::size_t threads = 1; threads <= 5; threads++) {
+    if (ResearchLibrary::CheckSum::ParallelCRC32(large, 0, threads)
+          != large_crc ||
+        ResearchLibrary::CheckSum::ParallelAdler32(large, 1, threads)
+          != large_adler) {
+      return 1;
+    }
+  }
+  std::vector<std::uint8_t> first(buffer.begin(), buffer.begin() + 1000);
+  std::vector<std::uint8_t> second(buffer.begin() + 1000, buffer.end());
+  if (ResearchLibrary::CheckSum::CRC32Combine(
+        ResearchLibrary::CheckSum::CRC32(first, 0),
+        ResearchLibrary::CheckSum::CRC32(second, 0),
+        second.size()) != crc ||
+      ResearchLibrary::CheckSum::Adler32Combine(
+        ResearchLibrary::CheckSum::Adler32(first, 1),
+        ResearchLibrary::CheckSum::Adler32(second, 1),
+        second.size()) != ResearchLibrary::CheckSum::Adler32(buffer, 1)) {
+    return 1;
+  }
+
+  ResearchLibrary::CheckSum::CRC32Hasher<> crc_hasher{};
+  ResearchLibrary::CheckSum::Adler32Hasher adler_hasher{};
+  for (std::size_t i = 0; i < buffer.size(); i += 777) {
+    auto length = std::min(std::size_t(777), buffer.size() - i);
+    crc_hasher.update(&buffer[i], length);
+    adler_hasher.update(&buffer[i], length);
+  }
+  if (crc_hasher.finish() != crc ||
+      adler_hasher.finish() != ResearchLibrary::CheckSum::Adler32(buffer, 1)) {
+    return 1;
+  }
+  std::list<std::uint8_t> list(check.begin(), check.end());
+  if (ResearchLibrary::CheckSum::CRC32Hasher<>()
+        .update(list.begin(), list.end()).finish() != 0xcbf43926 ||
+      ResearchLibrary::CheckSum::Adler32Hasher()
+        .update(list.begin(), list.end()).finish() != 0x091e01de) {
+    return 1;
+  }
   return 0;
 }
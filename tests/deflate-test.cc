@@ -24,5 +24,24 @@ int main() {
       return 1;
     }
   }
+
+  // back-references before the start of the output end the stream
+  for (std::size_t literals = 0; literals < 2; literals++) {
+    ResearchLibrary::BitsToBytes<8> corrupt{};
+    corrupt.put(1, 1);
+    corrupt.put(1, 2);
+    if (literals == 1) {
+      corrupt.rput(0x30 + 'a', 8);
+    }
+    // length 3 at distance literals + 1, then the end of the block
+    corrupt.rput(1, 7);
+    corrupt.rput(literals, 5);
+    corrupt.rput(0, 7);
+    auto&& decoded = ResearchLibrary::Deflate::Decode(
+        corrupt.seek_to_byte_boundary());
+    if (decoded.size() != literals) {
+      return 1;
+    }
+  }
   return 0;
 }
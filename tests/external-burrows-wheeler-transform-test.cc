@@ -0,0 +1,115 @@
+// Copyright 2015 pixie.grasper
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <csignal>
+
+#include <cstdlib>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../includes/external-burrows-wheeler-transform.h"
+
+int main() {
+  const char* input = "external-burrows-wheeler-transform-test.in.tmp";
+  const char* output = "external-burrows-wheeler-transform-test.out.tmp";
+  std::vector<std::uint8_t> buffer(30000);
+  unsigned int seed = 10;
+  for (std::size_t i = 0; i < buffer.size(); i++) {
+    buffer[i] = i >= 500 && rand_r(&seed) % 8 != 0
+              ? buffer[i - 500]
+              : std::uint8_t(rand_r(&seed) % 3);
+  }
+  std::vector<std::vector<std::uint8_t>> sources{
+    buffer, std::vector<std::uint8_t>(1000, 7), {1, 2, 3}, {}};
+  // a sequence repeated, whose equal rotations keep their order
+  for (std::size_t i = 0; i < 1000; i++) {
+    sources[1][i] = std::uint8_t(i % 3 == 0);
+  }
+
+  // budgets that sort in the memory, and in many runs on the disk
+  for (auto&& source : sources) {
+    auto&& reference = ResearchLibrary::BurrowsWheelerTransform::BWT(source);
+    for (std::size_t memory_budget : {1u << 24, 1u << 17, 1u << 16}) {
+      ResearchLibrary::File::save_as(input, source);
+      auto&& result = ResearchLibrary::BurrowsWheelerTransform
+                    ::ExternalBWT(input, output, memory_budget);
+      if (!result.second || result.first != reference.second ||
+          ResearchLibrary::File::load(output) != reference.first) {
+        unlink(input);
+        unlink(output);
+        return 1;
+      }
+    }
+  }
+  unlink(input);
+  unlink(output);
+  if (ResearchLibrary::BurrowsWheelerTransform
+      ::ExternalBWT(input, output).second) {
+    return 1;
+  }
+  unlink(output);
+
+  // a file that cannot be read is an error, not an empty one
+  namespace Transform = ResearchLibrary::BurrowsWheelerTransform;
+  if (Transform::external_sort<Transform::RotationPair>(
+          input, output, 1u << 16, Transform::pair_less<>)) {
+    return 1;
+  }
+  ResearchLibrary::File::save_as(input, std::vector<std::uint8_t>(30));
+  std::size_t index = 0;
+  if (Transform::external_sort<Transform::RotationRank>(
+          input, output, 1u << 16, Transform::position_less<>) ||
+      Transform::write_sorted_symbols(input, 2, output, 1u << 16, &index)) {
+    return 1;
+  }
+  ResearchLibrary::File::save_as(input, std::vector<std::uint8_t>(34));
+  if (Transform::write_sorted_symbols(input, 3, output, 1u << 16, &index) ||
+      !Transform::write_sorted_symbols(input, 2, output, 1u << 16, &index)) {
+    return 1;
+  }
+  unlink(input);
+  unlink(output);
+
+  // a full disk leaves no temporary files behind
+  {
+    ResearchLibrary::FileWriter writer(input);
+    for (std::size_t i = 0; i < buffer.size(); i++) {
+      Transform::RotationPair pair{};
+      pair.first = std::uint64_t(rand_r(&seed));
+      pair.position = i;
+      Transform::put_record(&writer, pair);
+    }
+  }
+  struct rlimit limit;
+  getrlimit(RLIMIT_FSIZE, &limit);
+  auto limited = limit;
+  limited.rlim_cur = 200000;
+  std::signal(SIGXFSZ, SIG_IGN);
+  setrlimit(RLIMIT_FSIZE, &limited);
+  auto sorted = Transform::external_sort<Transform::RotationPair>(
+      input, output, 1u << 16, Transform::pair_less<>);
+  ResearchLibrary::File::save_as(input, buffer);
+  auto transformed = Transform::ExternalBWT(input, output, 1u << 16).second;
+  setrlimit(RLIMIT_FSIZE, &limit);
+  unlink(input);
+  unlink(output);
+  if (sorted || transformed) {
+    return 1;
+  }
+  std::vector<std::string> names{"", ".tmp.pairs", ".tmp.sorted",
+                                 ".tmp.updates", ".tmp.ranks", ".tmp.merged"};
+  for (std::size_t k = 0; k < 100; k++) {
+    names.push_back(".run" + std::to_string(k));
+    names.push_back(".tmp.sorted.run" + std::to_string(k));
+    names.push_back(".tmp.ranks.run" + std::to_string(k));
+  }
+  for (auto&& name : names) {
+    if (access((std::string(output) + name).c_str(), F_OK) == 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
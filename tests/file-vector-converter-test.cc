@@ -1,7 +1,132 @@
 // Copyright 2015 pixie.grasper
 
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstdint>
+#include <vector>
+
 #include "../includes/file-vector-converter.h"
 
 int main() {
+  const char* name = "file-vector-converter-test.tmp";
+  std::vector<std::uint8_t> buffer(100000);
+  unsigned int seed = 10;
+  for (std::size_t i = 0; i < buffer.size(); i++) {
+    buffer[i] = static_cast<std::uint8_t>(rand_r(&seed));
+  }
+  ResearchLibrary::File::save_as(name, buffer);
+  {
+    auto&& mapped = ResearchLibrary::File::map(name);
+    if (mapped.size() != buffer.size()) {
+      unlink(name);
+      return 1;
+    }
+    for (std::size_t i = 0; i < buffer.size(); i++) {
+      if (mapped[i] != buffer[i]) {
+        unlink(name);
+        return 1;
+      }
+    }
+    if (mapped.to_vector() != ResearchLibrary::File::load(name)) {
+      unlink(name);
+      return 1;
+    }
+  }
+  {
+    ResearchLibrary::FileWriter writer(name, 1000);
+    for (std::size_t i = 0; i < buffer.size(); i += 333) {
+      auto length = buffer.size() - i < 333 ? buffer.size() - i : 333;
+      writer.write(&buffer[i], length);
+    }
+    writer.write(std::vector<std::uint8_t>(5000, 7));
+    if (!writer.good()) {
+      unlink(name);
+      return 1;
+    }
+  }
+  buffer.resize(buffer.size() + 5000, 7);
+  {
+    ResearchLibrary::FileReader reader(name, 4096);
+    std::size_t offset = 0;
+    while (!reader.eof()) {
+      auto&& block = reader.next();
+      if (block.size() != 4096 && !reader.eof()) {
+        unlink(name);
+        return 1;
+      }
+      for (std::size_t i = 0; i < block.size(); i++) {
+        if (block[i] != buffer[offset + i]) {
+          unlink(name);
+          return 1;
+        }
+      }
+      offset += block.size();
+    }
+    if (offset != buffer.size()) {
+      unlink(name);
+      return 1;
+    }
+  }
+  {
+    ResearchLibrary::WriteBehindFileWriter writer(name, 4000, 3);
+    for (std::size_t i = 0; i < buffer.size(); i += 1234) {
+      auto length = buffer.size() - i < 1234 ? buffer.size() - i : 1234;
+      writer.write(&buffer[i], length);
+    }
+    writer.flush();
+    if (!writer.good() || ResearchLibrary::File::load(name) != buffer) {
+      unlink(name);
+      return 1;
+    }
+  }
+  {
+    ResearchLibrary::ReadAheadFileReader reader(name, 4096, 3);
+    std::vector<std::uint8_t> contents{};
+    while (!reader.eof()) {
+      auto&& block = reader.next();
+      contents.insert(contents.end(), block.begin(), block.end());
+    }
+    if (contents != buffer || !reader.next().empty()) {
+      unlink(name);
+      return 1;
+    }
+  }
+  {
+    ResearchLibrary::SegmentList segments{};
+    for (std::size_t i = 0; i < buffer.size(); i += 29) {
+      auto length = buffer.size() - i < 29 ? buffer.size() - i : 29;
+      segments.push_back(&buffer[i], length);
+    }
+    ResearchLibrary::File::save_as(name, segments);
+    if (segments.size() != buffer.size() ||
+        ResearchLibrary::File::load(name) != buffer) {
+      unlink(name);
+      return 1;
+    }
+  }
+  unlink(name);
+  if (!ResearchLibrary::File::map(name).empty()) {
+    return 1;
+  }
+
+  // a missing file, and a read error, are not good
+  {
+    ResearchLibrary::FileReader missing(name);
+    ResearchLibrary::ReadAheadFileReader missing_ahead(name);
+    if (missing.good() || !missing.eof() ||
+        missing_ahead.good() || !missing_ahead.eof()) {
+      return 1;
+    }
+    // reading a directory fails with EISDIR
+    ResearchLibrary::FileReader directory(".");
+    ResearchLibrary::ReadAheadFileReader directory_ahead(".");
+    if (!directory.good() || !directory_ahead.good() ||
+        !directory.next().empty() || !directory_ahead.next().empty() ||
+        !directory.eof() || !directory_ahead.eof() ||
+        directory.good() || directory_ahead.good()) {
+      return 1;
+    }
+  }
   return 0;
 }
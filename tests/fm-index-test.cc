@@ -0,0 +1,75 @@
+// Copyright 2015 pixie.grasper
+
+#include <cstdlib>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../includes/fm-index.h"
+
+int main() {
+  std::vector<std::uint8_t> buffer(20000);
+  unsigned int seed = 10;
+  for (std::size_t i = 0; i < buffer.size(); i++) {
+    buffer[i] = i >= 1000 && rand_r(&seed) % 4 == 0
+              ? buffer[i - 1000]
+              : std::uint8_t(rand_r(&seed) % 4);
+  }
+
+  // every pattern gives the same positions as a naive search
+  for (std::size_t sample_rate : {1u, 7u, 32u}) {
+    ResearchLibrary::FMIndex::Index<std::uint8_t> index(buffer, sample_rate);
+    if (index.size() != buffer.size()) {
+      return 1;
+    }
+    for (std::size_t k = 0; k < 50; k++) {
+      auto start = std::size_t(rand_r(&seed)) % buffer.size();
+      auto length = std::size_t(rand_r(&seed)) % 12 + 1;
+      std::vector<std::uint8_t> pattern(
+          buffer.begin() + std::ptrdiff_t(start),
+          buffer.begin() + std::ptrdiff_t(std::min(start + length,
+                                                   buffer.size())));
+      if (k % 5 == 0) {
+        pattern.back() = std::uint8_t(rand_r(&seed) % 5);
+      }
+      std::vector<std::size_t> expected{};
+      for (std::size_t i = 0; i + pattern.size() <= buffer.size(); i++) {
+        if (std::equal(pattern.begin(), pattern.end(),
+                       buffer.begin() + std::ptrdiff_t(i))) {
+          expected.push_back(i);
+        }
+      }
+      if (index.count(pattern) != expected.size() ||
+          index.locate(pattern) != expected) {
+        return 1;
+      }
+    }
+  }
+
+  // symbols that are not small integers, and an empty sequence
+  std::vector<std::string> words{"pixie", "grasper", "pixie", "research",
+                                 "pixie", "grasper"};
+  ResearchLibrary::FMIndex::Index<std::string> word_index(words, 2);
+  std::vector<std::size_t> expected{0, 4};
+  if (word_index.locate({"pixie", "grasper"}) != expected ||
+      word_index.count({"grasper", "pixie"}) != 1 ||
+      word_index.count({"library"}) != 0) {
+    return 1;
+  }
+  ResearchLibrary::FMIndex::Index<std::uint8_t> empty(
+      std::vector<std::uint8_t>{});
+  if (empty.count({0}) != 0 || !empty.locate({0}).empty()) {
+    return 1;
+  }
+
+  // signed symbols keep their order
+  std::vector<std::int16_t> signed_symbols{-300, 5, -300, 5, 7, -300, 5};
+  ResearchLibrary::FMIndex::Index<std::int16_t> signed_index(signed_symbols);
+  std::vector<std::size_t> signed_expected{0, 2, 5};
+  if (signed_index.locate({-300, 5}) != signed_expected ||
+      signed_index.count({5, -300}) != 1 ||
+      signed_index.count({-299}) != 0) {
+    return 1;
+  }
+  return 0;
+}